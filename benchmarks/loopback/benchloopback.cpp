@@ -0,0 +1,396 @@
+#include <QtGlobal>
+
+#if defined(Q_OS_WIN)
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <unistd.h>
+#include <sys/resource.h>
+#if defined(Q_OS_MACOS)
+#include <mach/mach.h>
+#endif
+#endif
+
+#include <QFile>
+#include <QTimer>
+#include <QEventLoop>
+#include <QTextStream>
+#include <QApplication>
+#include <QElapsedTimer>
+#include <QModbusTcpServer>
+#include <QCommandLineParser>
+#include "formmodsca.h"
+#include "modbusclient.h"
+#include "datasimulator.h"
+#include "displayrefreshscheduler.h"
+#include "latencyhistogram.h"
+
+///
+/// \brief The size of the register map exposed by the server
+///
+static constexpr int MapSize = 10000;
+
+///
+/// \brief The BenchCase struct
+///
+struct BenchCase
+{
+    int Forms = 1;
+    int ScanRate = 100;
+    int Length = 10;
+};
+
+///
+/// \brief The BenchResult struct
+///
+struct BenchResult
+{
+    quint64 Polls = 0;
+    quint64 Errors = 0;
+    qint64 Elapsed = 0;
+    qint64 CpuTime = 0;
+    qint64 RssGrowth = 0;
+    LatencyHistogram Rtt;
+
+    double pollsPerSecond() const {
+        return Elapsed > 0 ? Polls * 1e6 / Elapsed : 0;
+    }
+
+    double cpuLoad() const {
+        return Elapsed > 0 ? 100.0 * CpuTime / Elapsed : 0;
+    }
+};
+
+///
+/// \brief cpuTime
+/// \return user and system CPU time of the process in microseconds
+///
+static qint64 cpuTime()
+{
+#if defined(Q_OS_WIN)
+    FILETIME creation, exit, kernel, user;
+    if(!GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel, &user))
+        return 0;
+
+    const auto usecs = [](const FILETIME& ft) {
+        return ((qint64(ft.dwHighDateTime) << 32) | ft.dwLowDateTime) / 10;
+    };
+    return usecs(kernel) + usecs(user);
+#else
+    rusage ru;
+    if(getrusage(RUSAGE_SELF, &ru) != 0)
+        return 0;
+
+    return (ru.ru_utime.tv_sec + ru.ru_stime.tv_sec) * 1000000LL + ru.ru_utime.tv_usec + ru.ru_stime.tv_usec;
+#endif
+}
+
+///
+/// \brief currentRss
+/// \return current resident set size of the process in kilobytes
+///
+static qint64 currentRss()
+{
+#if defined(Q_OS_WIN)
+    PROCESS_MEMORY_COUNTERS pmc;
+    if(!GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc)))
+        return 0;
+
+    return pmc.WorkingSetSize / 1024;
+#elif defined(Q_OS_MACOS)
+    mach_task_basic_info info;
+    mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+    if(task_info(mach_task_self(), MACH_TASK_BASIC_INFO, (task_info_t)&info, &count) != KERN_SUCCESS)
+        return 0;
+
+    return info.resident_size / 1024;
+#else
+    QFile file("/proc/self/statm");
+    if(!file.open(QFile::ReadOnly))
+        return 0;
+
+    // the second field is the number of resident pages
+    const auto fields = file.readAll().split(' ');
+    if(fields.size() < 2)
+        return 0;
+
+    return fields[1].toLongLong() * sysconf(_SC_PAGESIZE) / 1024;
+#endif
+}
+
+///
+/// \brief wait
+/// Runs the event loop for the given time
+/// \param msecs
+///
+static void wait(int msecs)
+{
+    QEventLoop loop;
+    QTimer::singleShot(msecs, &loop, &QEventLoop::quit);
+    loop.exec();
+}
+
+///
+/// \brief parseList
+/// \param text comma separated list of positive numbers
+/// \return
+///
+static QList<int> parseList(const QString& text)
+{
+    QList<int> values;
+    for(auto&& s : text.split(',', Qt::SkipEmptyParts))
+    {
+        bool ok;
+        const auto v = s.trimmed().toInt(&ok);
+        if(ok && v > 0) values.append(v);
+    }
+    return values;
+}
+
+///
+/// \brief startServer
+/// \param server
+/// \param port
+/// \return
+///
+static bool startServer(QModbusTcpServer& server, int port)
+{
+    QModbusDataUnitMap map;
+    map.insert(QModbusDataUnit::HoldingRegisters, { QModbusDataUnit::HoldingRegisters, 0, MapSize });
+    server.setMap(map);
+
+    QModbusDataUnit data(QModbusDataUnit::HoldingRegisters, 0, MapSize);
+    for(int i = 0; i < MapSize; i++)
+        data.setValue(i, quint16(i * 40503u));
+    server.setData(data);
+
+    server.setServerAddress(1);
+    server.setConnectionParameter(QModbusDevice::NetworkAddressParameter, "127.0.0.1");
+    server.setConnectionParameter(QModbusDevice::NetworkPortParameter, port);
+
+    return server.connectDevice();
+}
+
+///
+/// \brief connectClient
+/// \param client
+/// \param port
+/// \return
+///
+static bool connectClient(ModbusClient& client, int port)
+{
+    ConnectionDetails cd;
+    cd.Type = ConnectionType::Tcp;
+    cd.TcpParams.IPAddress = "127.0.0.1";
+    cd.TcpParams.ServicePort = port;
+    cd.ModbusParams.SlaveResponseTimeOut = 1000;
+    cd.ModbusParams.NumberOfRetries = 0;
+
+    QEventLoop loop;
+    QObject::connect(&client, &ModbusClient::modbusConnected, &loop, &QEventLoop::quit);
+    QObject::connect(&client, &ModbusClient::modbusConnectionError, &loop, &QEventLoop::quit);
+    QTimer::singleShot(5000, &loop, &QEventLoop::quit);
+
+    client.connectDevice(cd);
+    if(client.state() != QModbusDevice::ConnectedState)
+        loop.exec();
+
+    return client.state() == QModbusDevice::ConnectedState;
+}
+
+///
+/// \brief runCase
+/// \param client
+/// \param simulator
+/// \param bc
+/// \param duration measurement time in milliseconds
+/// \return
+///
+static BenchResult runCase(ModbusClient& client, DataSimulator& simulator, const BenchCase& bc, int duration)
+{
+    BenchResult result;
+    bool measuring = false;
+
+    auto conn = QObject::connect(&client, &ModbusClient::modbusReply, [&](QModbusReply* reply)
+    {
+        if(!measuring || !reply || reply->property("RequestId").toInt() <= 0)
+            return;
+
+        if(reply->error() != QModbusDevice::NoError)
+        {
+            result.Errors++;
+            return;
+        }
+
+        result.Polls++;
+        const auto rtt = ModbusClient::roundTripTime(reply);
+        if(rtt >= 0) result.Rtt.record(rtt);
+    });
+
+    DisplayDefinition dd;
+    dd.ScanRate = bc.ScanRate;
+    dd.DeviceId = 1;
+    dd.PointAddress = 1;
+    dd.PointType = QModbusDataUnit::HoldingRegisters;
+    dd.Length = bc.Length;
+    dd.normalize();
+
+    // the peak RSS is a lifetime maximum, only the growth of the current RSS belongs to this case
+    const auto rss = currentRss();
+
+    QWidget host;
+    QList<FormModSca*> forms;
+    for(int i = 0; i < bc.Forms; i++)
+    {
+        auto frm = new FormModSca(i + 1, client, &simulator, &host);
+        frm->setWindowFlag(Qt::Window);
+        frm->setDisplayDefinition(dd);
+        frm->show();
+        forms.append(frm);
+    }
+
+    // let the forms lay out, paint and settle their first polls
+    wait(500);
+
+    QElapsedTimer timer;
+    const auto cpu = cpuTime();
+    measuring = true;
+    timer.start();
+
+    wait(duration);
+
+    measuring = false;
+    result.Elapsed = timer.nsecsElapsed() / 1000;
+    result.CpuTime = cpuTime() - cpu;
+    result.RssGrowth = currentRss() - rss;
+
+    qDeleteAll(forms);
+    QObject::disconnect(conn);
+
+    // drain the replies still in flight so they do not leak into the next case
+    wait(qMax(200, bc.ScanRate));
+
+    return result;
+}
+
+///
+/// \brief formatMsecs
+/// \param usecs
+/// \return
+///
+static QString formatMsecs(qint64 usecs)
+{
+    return QString::number(usecs / 1000.0, 'f', 3);
+}
+
+///
+/// \brief main
+/// \param argc
+/// \param argv
+/// \return
+///
+int main(int argc, char* argv[])
+{
+    if(qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+
+    QApplication app(argc, argv);
+    app.setApplicationName("bench_loopback");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("End-to-end polling throughput against an in-process MODBUS/TCP server");
+    parser.addHelpOption();
+
+    const QCommandLineOption formsOption("forms", "Comma separated numbers of forms.", "list", "1,4,16");
+    const QCommandLineOption ratesOption("scan-rates", "Comma separated scan rates (ms).", "list", "20,100,1000");
+    const QCommandLineOption lengthsOption("lengths", "Comma separated request lengths (registers).", "list", "10,60,125");
+    const QCommandLineOption durationOption("duration", "Measurement time per case (ms).", "msecs", "5000");
+    const QCommandLineOption portOption("port", "Local TCP port of the server.", "port", "5502");
+    const QCommandLineOption csvOption("csv", "Also write the results to a CSV file.", "file");
+    const QCommandLineOption fpsOption("fps", "Display frame rate, 0 to repaint on every reply.", "fps", "30");
+    parser.addOptions({ formsOption, ratesOption, lengthsOption, durationOption, portOption, csvOption, fpsOption });
+    parser.process(app);
+
+    const auto forms = parseList(parser.value(formsOption));
+    const auto rates = parseList(parser.value(ratesOption));
+    const auto lengths = parseList(parser.value(lengthsOption));
+    const auto duration = qMax(100, parser.value(durationOption).toInt());
+    const auto port = parser.value(portOption).toInt();
+    DisplayRefreshScheduler::instance().setFrameRate(parser.value(fpsOption).toInt());
+
+    QTextStream out(stdout);
+
+    QModbusTcpServer server;
+    if(!startServer(server, port))
+    {
+        out << "Cannot start MODBUS server on port " << port << ": " << server.errorString() << Qt::endl;
+        return 1;
+    }
+
+    ModbusClient client;
+    DataSimulator simulator(nullptr);
+    if(!connectClient(client, port))
+    {
+        out << "Cannot connect to MODBUS server on port " << port << Qt::endl;
+        return 1;
+    }
+
+    QFile csvFile;
+    QTextStream csv;
+    if(parser.isSet(csvOption))
+    {
+        csvFile.setFileName(parser.value(csvOption));
+        if(!csvFile.open(QFile::WriteOnly | QFile::Truncate))
+        {
+            out << "Cannot open " << csvFile.fileName() << Qt::endl;
+            return 1;
+        }
+        csv.setDevice(&csvFile);
+        csv << "forms,scan_rate_ms,length,polls_per_sec,rtt_p50_ms,rtt_p90_ms,rtt_p99_ms,rtt_max_ms,errors,cpu_ms,cpu_percent,rss_growth_kb\n";
+    }
+
+    const QString rowFormat("%1 %2 %3 %4 %5 %6 %7 %8 %9 %10 %11 %12");
+    out << rowFormat.arg("forms", 5).arg("rate", 6).arg("length", 6).arg("polls/s", 9)
+                    .arg("p50 ms", 8).arg("p90 ms", 8).arg("p99 ms", 8).arg("max ms", 8)
+                    .arg("errors", 6).arg("cpu ms", 9).arg("cpu %", 6).arg("rss +KB", 8) << Qt::endl;
+
+    for(auto f : forms)
+    {
+        for(auto r : rates)
+        {
+            for(auto l : lengths)
+            {
+                const BenchCase bc { f, r, l };
+                const auto res = runCase(client, simulator, bc, duration);
+
+                out << rowFormat.arg(bc.Forms, 5).arg(bc.ScanRate, 6).arg(bc.Length, 6)
+                                .arg(res.pollsPerSecond(), 9, 'f', 1)
+                                .arg(formatMsecs(res.Rtt.percentile(50)), 8)
+                                .arg(formatMsecs(res.Rtt.percentile(90)), 8)
+                                .arg(formatMsecs(res.Rtt.percentile(99)), 8)
+                                .arg(formatMsecs(res.Rtt.max()), 8)
+                                .arg(res.Errors, 6)
+                                .arg(formatMsecs(res.CpuTime), 9)
+                                .arg(res.cpuLoad(), 6, 'f', 1)
+                                .arg(res.RssGrowth, 8) << Qt::endl;
+
+                if(csv.device())
+                {
+                    csv << bc.Forms << ',' << bc.ScanRate << ',' << bc.Length << ','
+                        << QString::number(res.pollsPerSecond(), 'f', 1) << ','
+                        << formatMsecs(res.Rtt.percentile(50)) << ','
+                        << formatMsecs(res.Rtt.percentile(90)) << ','
+                        << formatMsecs(res.Rtt.percentile(99)) << ','
+                        << formatMsecs(res.Rtt.max()) << ','
+                        << res.Errors << ',' << formatMsecs(res.CpuTime) << ','
+                        << QString::number(res.cpuLoad(), 'f', 1) << ',' << res.RssGrowth << '\n';
+                }
+            }
+        }
+    }
+
+    client.disconnectDevice();
+    server.disconnectDevice();
+
+    return 0;
+}
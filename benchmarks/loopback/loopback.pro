@@ -0,0 +1,33 @@
+QT += core gui widgets network printsupport serialbus serialport
+
+CONFIG += c++17 console
+CONFIG -= app_bundle
+CONFIG -= debug_and_release
+CONFIG -= debug_and_release_target
+
+TARGET = bench_loopback
+
+SRC_DIR = $$PWD/../../omodscan
+
+# Build the whole application except its entry point, so the forms,
+# the client and the display stack are exactly the ones that ship
+APP_SOURCES = $$fromfile($$SRC_DIR/omodscan.pro, SOURCES)
+APP_SOURCES -= main.cpp
+APP_HEADERS = $$fromfile($$SRC_DIR/omodscan.pro, HEADERS)
+APP_FORMS = $$fromfile($$SRC_DIR/omodscan.pro, FORMS)
+
+for(file, APP_SOURCES): SOURCES += $$SRC_DIR/$$file
+for(file, APP_HEADERS): HEADERS += $$SRC_DIR/$$file
+for(file, APP_FORMS): FORMS += $$SRC_DIR/$$file
+
+DEFINES += $$fromfile($$SRC_DIR/omodscan.pro, DEFINES)
+
+INCLUDEPATH += $$SRC_DIR \
+               $$SRC_DIR/controls \
+               $$SRC_DIR/dialogs \
+               $$SRC_DIR/modbusmessages \
+
+SOURCES += \
+    benchloopback.cpp
+
+win32: LIBS += -lpsapi
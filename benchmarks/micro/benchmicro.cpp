@@ -0,0 +1,926 @@
+#include <QtTest>
+#include <QApplication>
+#include <QImage>
+#include <QPainter>
+#include "formatutils.h"
+#include "formatpipeline.h"
+#include "glyphcache.h"
+#include "numericutils.h"
+#include "packedbits.h"
+#include "qmodbusadurtu.h"
+#include "registerdecoder.h"
+#include "registerhistory.h"
+#include "modbusmessages.h"
+#include "modbuslogwidget.h"
+#include "outputdataview.h"
+#include "outputwidget.h"
+
+Q_DECLARE_METATYPE(QModbusPdu::FunctionCode)
+Q_DECLARE_METATYPE(ModbusMessage::ProtocolType)
+
+///
+/// \brief The number of points a single form can display
+///
+static constexpr int Rows = 125;
+
+///
+/// \brief sink
+/// Keeps the optimizer from dropping benchmark bodies
+///
+static volatile quint64 sink;
+
+///
+/// \brief registers
+/// \return a deterministic register image
+///
+static QVector<quint16> registers()
+{
+    QVector<quint16> values(Rows);
+    quint32 seed = 0x12345678;
+    for(auto&& v : values)
+    {
+        seed = seed * 1664525 + 1013904223;
+        v = quint16(seed >> 16);
+    }
+    return values;
+}
+
+///
+/// \brief The BenchMicro class
+///
+class BenchMicro : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void formatUInt8Value_data();
+    void formatUInt8Value();
+    void formatUInt8Array_data();
+    void formatUInt8Array();
+    void formatUInt16Array_data();
+    void formatUInt16Array();
+    void formatUInt16Value_data();
+    void formatUInt16Value();
+    void formatRegisterValue_data();
+    void formatRegisterValue();
+    void formatPipeline_data();
+    void formatPipeline();
+    void formatAddress_data();
+    void formatAddress();
+
+    void makeValue_data();
+    void makeValue();
+    void decodeArray_data();
+    void decodeArray();
+    void historyAppend();
+    void historySeries_data();
+    void historySeries();
+    void diffBits();
+    void breakValue_data();
+    void breakValue();
+
+    void calculateCRC_data();
+    void calculateCRC();
+
+    void createMessage_data();
+    void createMessage();
+    void appendLog_data();
+    void appendLog();
+
+    void updateData_data();
+    void updateData();
+    void updateDataUnchanged_data();
+    void updateDataUnchanged();
+    void updateDataColumns();
+
+    void paintPages_data();
+    void paintPages();
+
+    void drawText_data();
+    void drawText();
+};
+
+///
+/// \brief addModeRows
+///
+static void addModeRows(bool withByteOrder)
+{
+    QTest::addColumn<DataDisplayMode>("mode");
+    QTest::addColumn<ByteOrder>("order");
+
+    const auto modes = {
+        DataDisplayMode::Binary, DataDisplayMode::UInt16, DataDisplayMode::Int16, DataDisplayMode::Hex,
+        DataDisplayMode::FloatingPt, DataDisplayMode::SwappedFP, DataDisplayMode::DblFloat, DataDisplayMode::SwappedDbl,
+        DataDisplayMode::Int32, DataDisplayMode::SwappedInt32, DataDisplayMode::UInt32, DataDisplayMode::SwappedUInt32,
+        DataDisplayMode::Int64, DataDisplayMode::SwappedInt64, DataDisplayMode::UInt64, DataDisplayMode::SwappedUInt64
+    };
+
+    for(auto mode : modes)
+    {
+        const auto name = QByteArray::number(int(mode));
+        if(withByteOrder)
+        {
+            QTest::newRow(QByteArray("mode" + name + "-le").constData()) << mode << ByteOrder::LittleEndian;
+            QTest::newRow(QByteArray("mode" + name + "-be").constData()) << mode << ByteOrder::BigEndian;
+        }
+        else
+        {
+            QTest::newRow(QByteArray("mode" + name).constData()) << mode << ByteOrder::LittleEndian;
+        }
+    }
+}
+
+///
+/// \brief BenchMicro::formatUInt8Value_data
+///
+void BenchMicro::formatUInt8Value_data()
+{
+    QTest::addColumn<DataDisplayMode>("mode");
+    QTest::newRow("dec") << DataDisplayMode::UInt16;
+    QTest::newRow("hex") << DataDisplayMode::Hex;
+}
+
+///
+/// \brief BenchMicro::formatUInt8Value
+///
+void BenchMicro::formatUInt8Value()
+{
+    QFETCH(DataDisplayMode, mode);
+
+    QBENCHMARK {
+        for(int i = 0; i < 256; i++)
+            sink += ::formatUInt8Value(mode, quint8(i)).size();
+    }
+}
+
+///
+/// \brief BenchMicro::formatUInt8Array_data
+///
+void BenchMicro::formatUInt8Array_data()
+{
+    QTest::addColumn<DataDisplayMode>("mode");
+    QTest::addColumn<int>("size");
+    QTest::newRow("dec-8") << DataDisplayMode::UInt16 << 8;
+    QTest::newRow("hex-8") << DataDisplayMode::Hex << 8;
+    QTest::newRow("dec-256") << DataDisplayMode::UInt16 << 256;
+    QTest::newRow("hex-256") << DataDisplayMode::Hex << 256;
+}
+
+///
+/// \brief BenchMicro::formatUInt8Array
+///
+void BenchMicro::formatUInt8Array()
+{
+    QFETCH(DataDisplayMode, mode);
+    QFETCH(int, size);
+
+    QByteArray data(size, Qt::Uninitialized);
+    for(int i = 0; i < size; i++)
+        data[i] = char(i * 7);
+
+    QBENCHMARK {
+        sink += ::formatUInt8Array(mode, data).size();
+    }
+}
+
+///
+/// \brief BenchMicro::formatUInt16Array_data
+///
+void BenchMicro::formatUInt16Array_data()
+{
+    QTest::addColumn<DataDisplayMode>("mode");
+    QTest::addColumn<ByteOrder>("order");
+    QTest::newRow("dec-le") << DataDisplayMode::UInt16 << ByteOrder::LittleEndian;
+    QTest::newRow("dec-be") << DataDisplayMode::UInt16 << ByteOrder::BigEndian;
+    QTest::newRow("hex-le") << DataDisplayMode::Hex << ByteOrder::LittleEndian;
+    QTest::newRow("hex-be") << DataDisplayMode::Hex << ByteOrder::BigEndian;
+}
+
+///
+/// \brief BenchMicro::formatUInt16Array
+///
+void BenchMicro::formatUInt16Array()
+{
+    QFETCH(DataDisplayMode, mode);
+    QFETCH(ByteOrder, order);
+
+    QByteArray data(Rows * 2, Qt::Uninitialized);
+    for(int i = 0; i < data.size(); i++)
+        data[i] = char(i * 13);
+
+    QBENCHMARK {
+        sink += ::formatUInt16Array(mode, data, order).size();
+    }
+}
+
+///
+/// \brief BenchMicro::formatUInt16Value_data
+///
+void BenchMicro::formatUInt16Value_data()
+{
+    QTest::addColumn<DataDisplayMode>("mode");
+    QTest::newRow("dec") << DataDisplayMode::UInt16;
+    QTest::newRow("hex") << DataDisplayMode::Hex;
+}
+
+///
+/// \brief BenchMicro::formatUInt16Value
+///
+void BenchMicro::formatUInt16Value()
+{
+    QFETCH(DataDisplayMode, mode);
+    const auto values = registers();
+
+    QBENCHMARK {
+        for(auto v : values)
+            sink += ::formatUInt16Value(mode, v).size();
+    }
+}
+
+///
+/// \brief BenchMicro::formatRegisterValue_data
+///
+void BenchMicro::formatRegisterValue_data()
+{
+    addModeRows(true);
+}
+
+///
+/// \brief BenchMicro::formatRegisterValue
+/// Formats a full form of holding registers the same way OutputListModel does
+///
+void BenchMicro::formatRegisterValue()
+{
+    QFETCH(DataDisplayMode, mode);
+    QFETCH(ByteOrder, order);
+
+    const auto type = QModbusDataUnit::HoldingRegisters;
+    const auto v = registers();
+    auto at = [&v](int i) { return i < v.size() ? v[i] : quint16(0); };
+
+    QVariant out;
+    QBENCHMARK {
+        for(int i = 0; i < Rows; i++)
+        {
+            QString s;
+            switch(mode)
+            {
+                case DataDisplayMode::Binary:        s = formatBinaryValue(type, v[i], order, out); break;
+                case DataDisplayMode::UInt16:        s = ::formatUInt16Value(type, v[i], order, out); break;
+                case DataDisplayMode::Int16:         s = formatInt16Value(type, v[i], order, out); break;
+                case DataDisplayMode::Hex:           s = formatHexValue(type, v[i], order, out); break;
+                case DataDisplayMode::FloatingPt:    s = formatFloatValue(type, v[i], at(i+1), order, i%2, out); break;
+                case DataDisplayMode::SwappedFP:     s = formatFloatValue(type, at(i+1), v[i], order, i%2, out); break;
+                case DataDisplayMode::DblFloat:      s = formatDoubleValue(type, v[i], at(i+1), at(i+2), at(i+3), order, i%4, out); break;
+                case DataDisplayMode::SwappedDbl:    s = formatDoubleValue(type, at(i+3), at(i+2), at(i+1), v[i], order, i%4, out); break;
+                case DataDisplayMode::Int32:         s = formatInt32Value(type, v[i], at(i+1), order, i%2, out); break;
+                case DataDisplayMode::SwappedInt32:  s = formatInt32Value(type, at(i+1), v[i], order, i%2, out); break;
+                case DataDisplayMode::UInt32:        s = formatUInt32Value(type, v[i], at(i+1), order, i%2, out); break;
+                case DataDisplayMode::SwappedUInt32: s = formatUInt32Value(type, at(i+1), v[i], order, i%2, out); break;
+                case DataDisplayMode::Int64:         s = formatInt64Value(type, v[i], at(i+1), at(i+2), at(i+3), order, i%4, out); break;
+                case DataDisplayMode::SwappedInt64:  s = formatInt64Value(type, at(i+3), at(i+2), at(i+1), v[i], order, i%4, out); break;
+                case DataDisplayMode::UInt64:        s = formatUInt64Value(type, v[i], at(i+1), at(i+2), at(i+3), order, i%4, out); break;
+                case DataDisplayMode::SwappedUInt64: s = formatUInt64Value(type, at(i+3), at(i+2), at(i+1), v[i], order, i%4, out); break;
+            }
+            sink += s.size();
+        }
+    }
+}
+
+///
+/// \brief BenchMicro::formatPipeline_data
+///
+void BenchMicro::formatPipeline_data()
+{
+    QTest::addColumn<DataDisplayMode>("mode");
+    QTest::addColumn<ByteOrder>("order");
+    QTest::addColumn<bool>("pipeline");
+
+    const auto modes = { DataDisplayMode::UInt16, DataDisplayMode::SwappedFP, DataDisplayMode::Int32, DataDisplayMode::DblFloat };
+    for(auto mode : modes)
+    {
+        for(auto pipeline : { false, true })
+        {
+            const auto name = QString("mode%1-be-%2").arg(int(mode)).arg(pipeline ? "pipeline" : "switch");
+            QTest::newRow(name.toLatin1().constData()) << mode << ByteOrder::BigEndian << pipeline;
+        }
+    }
+}
+
+///
+/// \brief BenchMicro::formatPipeline
+/// Formats a full form either through formatValue, which switches on the mode,
+/// point type and byte order for every point, or through a pipeline picked once
+///
+void BenchMicro::formatPipeline()
+{
+    QFETCH(DataDisplayMode, mode);
+    QFETCH(ByteOrder, order);
+    QFETCH(bool, pipeline);
+
+    const auto type = QModbusDataUnit::HoldingRegisters;
+    const QModbusDataUnit data(type, 0, registers());
+
+    QVariant out;
+    if(pipeline)
+    {
+        DecodedRegisters decoded;
+        QBENCHMARK {
+            decoded.decode(data, Rows, mode, order);
+            const auto format = ::formatPipeline(type, mode, order);
+            for(int i = 0; i < Rows; i++)
+                sink += format(data, decoded, i, Rows, out).size();
+        }
+    }
+    else
+    {
+        QBENCHMARK {
+            for(int i = 0; i < Rows; i++)
+                sink += formatValue(type, data, i, Rows, mode, order, out).size();
+        }
+    }
+}
+
+///
+/// \brief BenchMicro::formatAddress_data
+///
+void BenchMicro::formatAddress_data()
+{
+    QTest::addColumn<bool>("hex");
+    QTest::newRow("dec") << false;
+    QTest::newRow("hex") << true;
+}
+
+///
+/// \brief BenchMicro::formatAddress
+///
+void BenchMicro::formatAddress()
+{
+    QFETCH(bool, hex);
+
+    QBENCHMARK {
+        for(int i = 1; i <= Rows; i++)
+            sink += ::formatAddress(QModbusDataUnit::HoldingRegisters, i, hex).size();
+    }
+}
+
+///
+/// \brief addNumericRows
+///
+static void addNumericRows()
+{
+    QTest::addColumn<QString>("type");
+    QTest::addColumn<ByteOrder>("order");
+    QTest::addColumn<bool>("swapped");
+
+    for(auto type : { "uint16", "int32", "uint32", "float", "int64", "uint64", "double" })
+    {
+        for(auto order : { ByteOrder::LittleEndian, ByteOrder::BigEndian })
+        {
+            for(auto swapped : { false, true })
+            {
+                if(QLatin1String(type) == QLatin1String("uint16") && swapped)
+                    continue;
+
+                const auto name = QString("%1-%2%3").arg(type, order == ByteOrder::LittleEndian ? "le" : "be", swapped ? "-swapped" : "");
+                QTest::newRow(name.toLatin1().constData()) << QString(type) << order << swapped;
+            }
+        }
+    }
+}
+
+///
+/// \brief BenchMicro::makeValue_data
+///
+void BenchMicro::makeValue_data()
+{
+    addNumericRows();
+}
+
+///
+/// \brief BenchMicro::makeValue
+///
+void BenchMicro::makeValue()
+{
+    QFETCH(QString, type);
+    QFETCH(ByteOrder, order);
+    QFETCH(bool, swapped);
+
+    const auto v = registers();
+    const int step = (type == "int64" || type == "uint64" || type == "double") ? 4 : 2;
+
+    QBENCHMARK {
+        quint64 acc = 0;
+        for(int i = 0; i + step <= v.size(); i += step)
+        {
+            quint16 w[4] = {};
+            for(int k = 0; k < step; k++)
+                w[k] = swapped ? v[i + step - 1 - k] : v[i + k];
+
+            if(type == "uint16")        acc += makeUInt16(quint8(w[0]), quint8(w[0] >> 8), order);
+            else if(type == "int32")    acc += makeInt32(w[0], w[1], order);
+            else if(type == "uint32")   acc += makeUInt32(w[0], w[1], order);
+            else if(type == "float")    acc += quint64(makeFloat(w[0], w[1], order));
+            else if(type == "int64")    acc += makeInt64(w[0], w[1], w[2], w[3], order);
+            else if(type == "uint64")   acc += makeUInt64(w[0], w[1], w[2], w[3], order);
+            else if(type == "double")   acc += quint64(makeDouble(w[0], w[1], w[2], w[3], order));
+        }
+        sink += acc;
+    }
+}
+
+///
+/// \brief BenchMicro::decodeArray_data
+///
+void BenchMicro::decodeArray_data()
+{
+    addNumericRows();
+}
+
+///
+/// \brief BenchMicro::decodeArray
+/// Same values as makeValue, decoded in one pass over the register image
+///
+void BenchMicro::decodeArray()
+{
+    QFETCH(QString, type);
+    QFETCH(ByteOrder, order);
+    QFETCH(bool, swapped);
+
+    const auto v = registers();
+    const int step = (type == "int64" || type == "uint64" || type == "double") ? 4 : (type == "uint16" ? 1 : 2);
+    const int count = v.size() / step;
+    QVector<quint64> out(count);
+
+    QBENCHMARK {
+        if(type == "uint16")        decodeUInt16Array(v.constData(), count, order, reinterpret_cast<quint16*>(out.data()));
+        else if(type == "int32")    decodeInt32Array(v.constData(), count, order, swapped, reinterpret_cast<qint32*>(out.data()));
+        else if(type == "uint32")   decodeUInt32Array(v.constData(), count, order, swapped, reinterpret_cast<quint32*>(out.data()));
+        else if(type == "float")    decodeFloatArray(v.constData(), count, order, swapped, reinterpret_cast<float*>(out.data()));
+        else if(type == "int64")    decodeInt64Array(v.constData(), count, order, swapped, reinterpret_cast<qint64*>(out.data()));
+        else if(type == "uint64")   decodeUInt64Array(v.constData(), count, order, swapped, reinterpret_cast<quint64*>(out.data()));
+        else if(type == "double")   decodeDoubleArray(v.constData(), count, order, swapped, reinterpret_cast<double*>(out.data()));
+        sink += out[0];
+    }
+}
+
+///
+/// \brief HistoryDepth
+///
+static constexpr int HistoryDepth = 1024;
+
+///
+/// \brief BenchMicro::historyAppend
+/// One sample into a full history, what every reply of a form with a history costs
+///
+void BenchMicro::historyAppend()
+{
+    QModbusDataUnit data(QModbusDataUnit::HoldingRegisters, 0, Rows);
+    data.setValues(registers());
+
+    RegisterHistory history;
+    history.setup(HistoryDepth, Rows);
+    for(int i = 0; i < HistoryDepth; i++)
+        history.append(data, i);
+
+    qint64 t = HistoryDepth;
+    QBENCHMARK {
+        history.append(data, t++);
+    }
+    sink += history.size();
+}
+
+///
+/// \brief BenchMicro::historySeries_data
+///
+void BenchMicro::historySeries_data()
+{
+    addModeRows(false);
+}
+
+///
+/// \brief BenchMicro::historySeries
+/// The values of one row over a full history, what every sparkline paints from
+///
+void BenchMicro::historySeries()
+{
+    QFETCH(DataDisplayMode, mode);
+    QFETCH(ByteOrder, order);
+
+    auto values = registers();
+    QModbusDataUnit data(QModbusDataUnit::HoldingRegisters, 0, Rows);
+
+    RegisterHistory history;
+    history.setup(HistoryDepth, Rows);
+    for(int i = 0; i < HistoryDepth; i++)
+    {
+        values[0] += i;
+        data.setValues(values);
+        history.append(data, i);
+    }
+
+    QVector<double> series;
+    QBENCHMARK {
+        sink += history.series(0, mode, order, series);
+    }
+}
+
+///
+/// \brief BenchMicro::diffBits
+/// Packs a block of the largest coil read and compares it with the previous one
+///
+void BenchMicro::diffBits()
+{
+    const int count = 2000;
+    QModbusDataUnit data(QModbusDataUnit::Coils, 0, count);
+    for(int i = 0; i < count; i++)
+        data.setValue(i, (i * 7) % 3 == 0);
+
+    PackedBits last, bits, changed;
+    last.resize(count);
+
+    QBENCHMARK {
+        bits.assign(data, count);
+        sink += bits.diff(last, changed);
+    }
+    sink += changed.nextSetBit(0);
+}
+
+///
+/// \brief BenchMicro::breakValue_data
+///
+void BenchMicro::breakValue_data()
+{
+    addNumericRows();
+}
+
+///
+/// \brief BenchMicro::breakValue
+///
+void BenchMicro::breakValue()
+{
+    QFETCH(QString, type);
+    QFETCH(ByteOrder, order);
+    QFETCH(bool, swapped);
+
+    QBENCHMARK {
+        quint64 acc = 0;
+        for(int i = 0; i < Rows; i++)
+        {
+            quint16 w[4] = {};
+            quint8 lo = 0, hi = 0;
+
+            if(type == "uint16")        { breakUInt16(quint16(i * 523), lo, hi, order); w[0] = lo | (hi << 8); }
+            else if(type == "int32")    breakInt32(i * -104729, w[0], w[1], order);
+            else if(type == "uint32")   breakUInt32(quint32(i) * 2654435761u, w[0], w[1], order);
+            else if(type == "float")    breakFloat(i * 0.37f, w[0], w[1], order);
+            else if(type == "int64")    breakInt64(qint64(i) * -6700417, w[0], w[1], w[2], w[3], order);
+            else if(type == "uint64")   breakUInt64(quint64(i) * 11400714819323198485ull, w[0], w[1], w[2], w[3], order);
+            else if(type == "double")   breakDouble(i * 0.123456789, w[0], w[1], w[2], w[3], order);
+
+            acc += swapped ? (quint64(w[0]) << 48 | quint64(w[1]) << 32 | quint64(w[2]) << 16 | w[3]) :
+                             (quint64(w[3]) << 48 | quint64(w[2]) << 32 | quint64(w[1]) << 16 | w[0]);
+        }
+        sink += acc;
+    }
+}
+
+///
+/// \brief BenchMicro::calculateCRC_data
+///
+void BenchMicro::calculateCRC_data()
+{
+    QTest::addColumn<int>("size");
+    QTest::newRow("request-8") << 8;
+    QTest::newRow("response-255") << 255;
+}
+
+///
+/// \brief BenchMicro::calculateCRC
+///
+void BenchMicro::calculateCRC()
+{
+    QFETCH(int, size);
+
+    QByteArray data(size, Qt::Uninitialized);
+    for(int i = 0; i < size; i++)
+        data[i] = char(i * 31 + 7);
+
+    QBENCHMARK {
+        sink += QModbusAduRtu::calculateCRC(data.constData(), data.size());
+    }
+}
+
+///
+/// \brief BenchMicro::createMessage_data
+///
+void BenchMicro::createMessage_data()
+{
+    QTest::addColumn<QModbusPdu::FunctionCode>("func");
+    QTest::addColumn<QByteArray>("data");
+    QTest::addColumn<bool>("request");
+    QTest::addColumn<ModbusMessage::ProtocolType>("protocol");
+
+    const struct {
+        const char* name;
+        QModbusPdu::FunctionCode func;
+        const char* request;
+        const char* response;
+    } frames[] = {
+        { "readCoils",                  QModbusPdu::ReadCoils,                  "00000010", "0255aa" },
+        { "readDiscreteInputs",         QModbusPdu::ReadDiscreteInputs,         "00000010", "0255aa" },
+        { "readHoldingRegisters",       QModbusPdu::ReadHoldingRegisters,       "0000000a", "14000100020003000400050006000700080009000a" },
+        { "readInputRegisters",         QModbusPdu::ReadInputRegisters,         "0000000a", "14000100020003000400050006000700080009000a" },
+        { "writeSingleCoil",            QModbusPdu::WriteSingleCoil,            "0001ff00", "0001ff00" },
+        { "writeSingleRegister",        QModbusPdu::WriteSingleRegister,        "00011234", "00011234" },
+        { "readExceptionStatus",        QModbusPdu::ReadExceptionStatus,        "",         "6d" },
+        { "diagnostics",                QModbusPdu::Diagnostics,                "0000a537", "0000a537" },
+        { "getCommEventCounter",        QModbusPdu::GetCommEventCounter,        "",         "00000108" },
+        { "getCommEventLog",            QModbusPdu::GetCommEventLog,            "",         "080000010801212000" },
+        { "writeMultipleCoils",         QModbusPdu::WriteMultipleCoils,         "0013000a02cd01", "0013000a" },
+        { "writeMultipleRegisters",     QModbusPdu::WriteMultipleRegisters,     "0001000204000a0102", "00010002" },
+        { "reportServerId",             QModbusPdu::ReportServerId,             "",         "0301ff00" },
+        { "readFileRecord",             QModbusPdu::ReadFileRecord,             "0e0600040001000206000300090002", "0c05060df800200506335a0014" },
+        { "writeFileRecord",            QModbusPdu::WriteFileRecord,            "0d0600040007000306af04be100d", "0d0600040007000306af04be100d" },
+        { "maskWriteRegister",          QModbusPdu::MaskWriteRegister,          "000400f20025", "000400f20025" },
+        { "readWriteMultipleRegisters", QModbusPdu::ReadWriteMultipleRegisters, "00030006000e00030600ff00ff00ff", "0c00fe0acd00010003000d00ff" },
+        { "readFifoQueue",              QModbusPdu::ReadFifoQueue,              "04de",     "0006000201b81284" }
+    };
+
+    for(auto&& f : frames)
+    {
+        for(auto protocol : { ModbusMessage::Rtu, ModbusMessage::Tcp })
+        {
+            const auto suffix = QByteArray(protocol == ModbusMessage::Rtu ? "-rtu" : "-tcp");
+            QTest::newRow(QByteArray(f.name + QByteArray("-request") + suffix).constData())
+                << f.func << QByteArray::fromHex(f.request) << true << protocol;
+            QTest::newRow(QByteArray(f.name + QByteArray("-response") + suffix).constData())
+                << f.func << QByteArray::fromHex(f.response) << false << protocol;
+        }
+    }
+}
+
+///
+/// \brief BenchMicro::createMessage
+///
+void BenchMicro::createMessage()
+{
+    QFETCH(QModbusPdu::FunctionCode, func);
+    QFETCH(QByteArray, data);
+    QFETCH(bool, request);
+    QFETCH(ModbusMessage::ProtocolType, protocol);
+
+    const QModbusPdu pdu = request ? QModbusPdu(QModbusRequest(func, data)) : QModbusPdu(QModbusResponse(func, data));
+    const auto timestamp = QDateTime::currentDateTime();
+
+    QBENCHMARK {
+        auto msg = ModbusMessage::create(pdu, protocol, 1, timestamp, request);
+        sink += msg->isValid();
+        delete msg;
+    }
+}
+
+///
+/// \brief BenchMicro::appendLog_data
+///
+void BenchMicro::appendLog_data()
+{
+    createMessage_data();
+}
+
+///
+/// \brief BenchMicro::appendLog
+/// A full traffic log where every new frame takes the place of the oldest one
+///
+void BenchMicro::appendLog()
+{
+    QFETCH(QModbusPdu::FunctionCode, func);
+    QFETCH(QByteArray, data);
+    QFETCH(bool, request);
+    QFETCH(ModbusMessage::ProtocolType, protocol);
+
+    const QModbusPdu pdu = request ? QModbusPdu(QModbusRequest(func, data)) : QModbusPdu(QModbusResponse(func, data));
+    const auto timestamp = QDateTime::currentDateTime();
+
+    ModbusLogWidget log;
+    for(int i = 0; i < log.rowLimit(); i++)
+        log.addItem(pdu, protocol, 1, i, timestamp, request);
+
+    int transactionId = 0;
+    QBENCHMARK {
+        sink += log.addItem(pdu, protocol, 1, transactionId++, timestamp, request).row();
+    }
+}
+
+///
+/// \brief BenchMicro::updateData_data
+///
+void BenchMicro::updateData_data()
+{
+    addModeRows(true);
+}
+
+///
+/// \brief BenchMicro::updateData
+/// A fully visible form where every value changes on every poll
+///
+void BenchMicro::updateData()
+{
+    QFETCH(DataDisplayMode, mode);
+    QFETCH(ByteOrder, order);
+
+    DisplayDefinition dd;
+    dd.PointType = QModbusDataUnit::HoldingRegisters;
+    dd.PointAddress = 1;
+    dd.Length = Rows;
+
+    OutputWidget widget;
+    widget.setup(dd, ModbusMessage::Tcp, ModbusSimulationMap());
+    widget.setDataDisplayMode(mode);
+    widget.setByteOrder(order);
+
+    // every word changes on every poll
+    auto values = registers();
+    QModbusDataUnit data[2] = { { QModbusDataUnit::HoldingRegisters, 0, Rows }, { QModbusDataUnit::HoldingRegisters, 0, Rows } };
+    data[0].setValues(values);
+    for(auto&& v : values) v = ~v;
+    data[1].setValues(values);
+
+    // rows are formatted when the view asks for them, so ask for all of them
+    const auto model = widget.findChild<OutputDataView*>("dataView")->model();
+
+    int n = 0;
+    QBENCHMARK {
+        widget.updateData(data[n++ & 1]);
+        for(int row = 0; row < Rows; row++)
+            sink += model->data(model->index(row, 0), Qt::DisplayRole).toString().size();
+    }
+}
+
+///
+/// \brief BenchMicro::updateDataUnchanged_data
+///
+void BenchMicro::updateDataUnchanged_data()
+{
+    addModeRows(false);
+}
+
+///
+/// \brief BenchMicro::updateDataUnchanged
+/// Polls of a device whose values do not change
+///
+void BenchMicro::updateDataUnchanged()
+{
+    QFETCH(DataDisplayMode, mode);
+
+    DisplayDefinition dd;
+    dd.PointType = QModbusDataUnit::HoldingRegisters;
+    dd.PointAddress = 1;
+    dd.Length = Rows;
+
+    OutputWidget widget;
+    widget.setup(dd, ModbusMessage::Tcp, ModbusSimulationMap());
+    widget.setDataDisplayMode(mode);
+
+    QModbusDataUnit data(QModbusDataUnit::HoldingRegisters, 0, Rows);
+    data.setValues(registers());
+    widget.updateData(data);
+
+    QBENCHMARK {
+        widget.updateData(data);
+    }
+}
+
+///
+/// \brief BenchMicro::updateDataColumns
+/// Hex with Int16, UInt16 and Float columns, the first three share one decode pass
+///
+void BenchMicro::updateDataColumns()
+{
+    DisplayDefinition dd;
+    dd.PointType = QModbusDataUnit::HoldingRegisters;
+    dd.PointAddress = 1;
+    dd.Length = Rows;
+
+    OutputWidget widget;
+    widget.setup(dd, ModbusMessage::Tcp, ModbusSimulationMap());
+    widget.setDataDisplayMode(DataDisplayMode::Hex);
+    widget.setExtraColumns({ DataDisplayMode::Int16, DataDisplayMode::UInt16, DataDisplayMode::FloatingPt });
+
+    auto values = registers();
+    QModbusDataUnit data[2] = { { QModbusDataUnit::HoldingRegisters, 0, Rows }, { QModbusDataUnit::HoldingRegisters, 0, Rows } };
+    data[0].setValues(values);
+    for(auto&& v : values) v = ~v;
+    data[1].setValues(values);
+
+    const auto model = widget.findChild<OutputDataView*>("dataView")->model();
+
+    int n = 0;
+    QBENCHMARK {
+        widget.updateData(data[n++ & 1]);
+        for(int row = 0; row < Rows; row++)
+            sink += model->data(model->index(row, 0), Qt::DisplayRole).toString().size();
+    }
+}
+
+///
+/// \brief BenchMicro::paintPages_data
+///
+void BenchMicro::paintPages_data()
+{
+    addModeRows(false);
+}
+
+///
+/// \brief BenchMicro::paintPages
+/// Lays a form out on pages small enough to need several of them, as printing does
+///
+void BenchMicro::paintPages()
+{
+    QFETCH(DataDisplayMode, mode);
+
+    DisplayDefinition dd;
+    dd.PointType = QModbusDataUnit::HoldingRegisters;
+    dd.PointAddress = 1;
+    dd.Length = Rows;
+
+    OutputWidget widget;
+    widget.setup(dd, ModbusMessage::Tcp, ModbusSimulationMap());
+    widget.setDataDisplayMode(mode);
+
+    QModbusDataUnit data(QModbusDataUnit::HoldingRegisters, 0, Rows);
+    data.setValues(registers());
+    widget.updateData(data);
+
+    QImage page(400, 300, QImage::Format_RGB32);
+    QPainter painter(&page);
+
+    QBENCHMARK {
+        int row = 0, pages = 1;
+        const int cellWidth = widget.printCellWidth(painter.fontMetrics());
+        while(widget.paint(page.rect(), painter, row, cellWidth))
+            pages++;
+        sink += pages;
+    }
+}
+
+///
+/// \brief BenchMicro::drawText_data
+///
+void BenchMicro::drawText_data()
+{
+    QTest::addColumn<bool>("glyphs");
+    QTest::newRow("drawText") << false;
+    QTest::newRow("glyphCache") << true;
+}
+
+///
+/// \brief BenchMicro::drawText
+/// A screen of data view cells, laid out by QPainter or drawn from the glyph cache
+///
+void BenchMicro::drawText()
+{
+    QFETCH(bool, glyphs);
+
+    const auto values = registers();
+    QStringList texts;
+    for(int i = 0; i < values.size(); i++)
+        texts.append(QString("%1: %2").arg(formatAddress(QModbusDataUnit::HoldingRegisters, i + 1, false), formatUInt16Register(values[i])));
+
+    QImage image(800, 600, QImage::Format_ARGB32_Premultiplied);
+    QPainter painter(&image);
+    painter.setFont(QFont("Courier", 10));
+    painter.setPen(Qt::black);
+
+    const int height = painter.fontMetrics().height();
+    auto& cache = GlyphCache::instance();
+
+    QBENCHMARK {
+        for(int i = 0; i < texts.size(); i++)
+        {
+            const QRect rc(i / 40 * 200, i % 40 * height, 200, height);
+            if(glyphs)
+                cache.drawText(painter, rc, texts[i]);
+            else
+                painter.drawText(rc, Qt::AlignLeft | Qt::AlignVCenter | Qt::TextSingleLine, texts[i]);
+        }
+    }
+}
+
+///
+/// \brief main
+///
+int main(int argc, char* argv[])
+{
+    if(qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+
+    QApplication app(argc, argv);
+    app.setAttribute(Qt::AA_Use96Dpi, true);
+
+    BenchMicro bench;
+    QTEST_SET_MAIN_SOURCE_PATH
+    return QTest::qExec(&bench, argc, argv);
+}
+
+#include "benchmicro.moc"
@@ -0,0 +1,711 @@
+#include <new>
+#include <atomic>
+#include <cstdlib>
+#include <algorithm>
+#include <QDir>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QTextStream>
+#include <QApplication>
+#include <QJsonDocument>
+#include <QElapsedTimer>
+#include <QTemporaryDir>
+#include <QCommandLineParser>
+#include "modbuslogwidget.h"
+#include "outputdataview.h"
+#include "outputwidget.h"
+
+///
+/// \brief Number of heap allocations made by the process
+///
+static std::atomic<quint64> allocations { 0 };
+
+#if defined(__GLIBC__)
+// Qt containers allocate with malloc() directly, so count at that level
+extern "C" {
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t n, size_t size);
+void* __libc_realloc(void* ptr, size_t size);
+void __libc_free(void* ptr);
+
+void* malloc(size_t size)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    return __libc_malloc(size);
+}
+
+void* calloc(size_t n, size_t size)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    return __libc_calloc(n, size);
+}
+
+void* realloc(void* ptr, size_t size)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    return __libc_realloc(ptr, size);
+}
+
+void free(void* ptr)
+{
+    __libc_free(ptr);
+}
+}
+#else
+// elsewhere only the allocations made through operator new are seen
+void* operator new(std::size_t size)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if(auto ptr = std::malloc(size ? size : 1))
+        return ptr;
+
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    return std::malloc(size ? size : 1);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t& tag) noexcept
+{
+    return operator new(size, tag);
+}
+
+void operator delete(void* ptr) noexcept                        { std::free(ptr); }
+void operator delete[](void* ptr) noexcept                      { std::free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept           { std::free(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept         { std::free(ptr); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept   { std::free(ptr); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { std::free(ptr); }
+#endif
+
+///
+/// \brief sink
+/// Keeps the optimizer from dropping the replay loops
+///
+static volatile quint64 sink;
+
+///
+/// \brief The replay stages in report order
+///
+static const char* const Stages[] = { "parse", "log", "capture", "update" };
+static constexpr int StageCount = 4;
+
+///
+/// \brief The Frame struct
+///
+struct Frame
+{
+    qint64 Offset = 0;
+    bool Request = false;
+    QByteArray Adu;
+};
+
+///
+/// \brief The Session struct
+/// A recorded exchange with a single device
+///
+struct Session
+{
+    QString Name;
+    ModbusMessage::ProtocolType Protocol = ModbusMessage::Tcp;
+    DataDisplayMode Mode = DataDisplayMode::UInt16;
+    QVector<Frame> Frames;
+};
+
+///
+/// \brief The Traffic struct
+/// A frame decoded the way ModbusClient hands it to a form
+///
+struct Traffic
+{
+    bool Request = false;
+    int DeviceId = 0;
+    int TransactionId = 0;
+    QModbusPdu Pdu;
+};
+
+///
+/// \brief The StageResult struct
+///
+struct StageResult
+{
+    int Items = 0;
+    qint64 Nsecs = -1;
+    quint64 Allocations = 0;
+
+    double nsPerItem() const {
+        return Items > 0 ? double(Nsecs) / Items : 0;
+    }
+
+    double allocationsPerItem() const {
+        return Items > 0 ? double(Allocations) / Items : 0;
+    }
+};
+
+///
+/// \brief The Measure class
+/// Times a block and counts the allocations it makes, keeping the best run
+///
+class Measure
+{
+public:
+    explicit Measure(StageResult& result)
+        :_result(result)
+        ,_first(result.Nsecs < 0)
+        ,_allocations(allocations.load(std::memory_order_relaxed))
+    {
+        _timer.start();
+    }
+
+    ~Measure()
+    {
+        const auto nsecs = _timer.nsecsElapsed();
+        const auto count = allocations.load(std::memory_order_relaxed) - _allocations;
+
+        if(_first || nsecs < _result.Nsecs) _result.Nsecs = nsecs;
+        if(_first || count < _result.Allocations) _result.Allocations = count;
+    }
+
+private:
+    StageResult& _result;
+    bool _first;
+    quint64 _allocations;
+    QElapsedTimer _timer;
+};
+
+///
+/// \brief parseMode
+/// \param name
+/// \param mode
+/// \return
+///
+static bool parseMode(const QString& name, DataDisplayMode& mode)
+{
+    static const QMap<QString, DataDisplayMode> modes = {
+        { "Binary", DataDisplayMode::Binary },         { "UInt16", DataDisplayMode::UInt16 },
+        { "Int16", DataDisplayMode::Int16 },           { "Hex", DataDisplayMode::Hex },
+        { "FloatingPt", DataDisplayMode::FloatingPt }, { "SwappedFP", DataDisplayMode::SwappedFP },
+        { "DblFloat", DataDisplayMode::DblFloat },     { "SwappedDbl", DataDisplayMode::SwappedDbl },
+        { "Int32", DataDisplayMode::Int32 },           { "SwappedInt32", DataDisplayMode::SwappedInt32 },
+        { "UInt32", DataDisplayMode::UInt32 },         { "SwappedUInt32", DataDisplayMode::SwappedUInt32 },
+        { "Int64", DataDisplayMode::Int64 },           { "SwappedInt64", DataDisplayMode::SwappedInt64 },
+        { "UInt64", DataDisplayMode::UInt64 },         { "SwappedUInt64", DataDisplayMode::SwappedUInt64 }
+    };
+
+    if(!modes.contains(name))
+        return false;
+
+    mode = modes.value(name);
+    return true;
+}
+
+///
+/// \brief loadSession
+/// Reads a session file. Every line is either a comment (#), a setting
+/// (protocol tcp|rtu, mode <DataDisplayMode>) or a frame:
+/// <offset in microseconds> <Tx|Rx> <ADU in hex>
+/// \param filename
+/// \param session
+/// \param error
+/// \return
+///
+static bool loadSession(const QString& filename, Session& session, QString& error)
+{
+    QFile file(filename);
+    if(!file.open(QFile::ReadOnly | QFile::Text))
+    {
+        error = file.errorString();
+        return false;
+    }
+
+    session.Name = QFileInfo(filename).completeBaseName();
+
+    int lineNumber = 0;
+    QTextStream in(&file);
+    while(!in.atEnd())
+    {
+        lineNumber++;
+        const auto line = in.readLine().trimmed();
+        if(line.isEmpty() || line.startsWith('#'))
+            continue;
+
+        const auto fields = line.split(' ', Qt::SkipEmptyParts);
+        if(fields.size() == 2 && fields[0] == "protocol" && (fields[1] == "tcp" || fields[1] == "rtu"))
+        {
+            session.Protocol = fields[1] == "tcp" ? ModbusMessage::Tcp : ModbusMessage::Rtu;
+            continue;
+        }
+
+        if(fields.size() == 2 && fields[0] == "mode" && parseMode(fields[1], session.Mode))
+            continue;
+
+        bool ok = false;
+        Frame frame;
+        if(fields.size() == 3)
+        {
+            frame.Offset = fields[0].toLongLong(&ok);
+            frame.Request = fields[1] == "Tx";
+            frame.Adu = QByteArray::fromHex(fields[2].toLatin1());
+            ok = ok && (frame.Request || fields[1] == "Rx") && !frame.Adu.isEmpty();
+        }
+
+        if(!ok)
+        {
+            error = QString("line %1: cannot parse '%2'").arg(lineNumber).arg(line);
+            return false;
+        }
+
+        session.Frames.append(frame);
+    }
+
+    if(session.Frames.isEmpty())
+    {
+        error = "no frames";
+        return false;
+    }
+
+    return true;
+}
+
+///
+/// \brief registerType
+/// \param func
+/// \return the table a read function works on
+///
+static QModbusDataUnit::RegisterType registerType(QModbusPdu::FunctionCode func)
+{
+    switch(func)
+    {
+        case QModbusPdu::ReadCoils:                 return QModbusDataUnit::Coils;
+        case QModbusPdu::ReadDiscreteInputs:        return QModbusDataUnit::DiscreteInputs;
+        case QModbusPdu::ReadHoldingRegisters:      return QModbusDataUnit::HoldingRegisters;
+        case QModbusPdu::ReadInputRegisters:        return QModbusDataUnit::InputRegisters;
+        default:                                    return QModbusDataUnit::Invalid;
+    }
+}
+
+///
+/// \brief decodeReadResponse
+/// \param request
+/// \param response
+/// \return the data unit ModbusClient would deliver for the response
+///
+static QModbusDataUnit decodeReadResponse(const QModbusPdu& request, const QModbusPdu& response)
+{
+    const auto type = registerType(request.functionCode());
+    const auto req = request.data();
+    const auto resp = response.data();
+
+    if(type == QModbusDataUnit::Invalid || response.isException() ||
+       response.functionCode() != request.functionCode() || req.size() < 4 || resp.isEmpty())
+    {
+        return QModbusDataUnit();
+    }
+
+    const auto address = makeUInt16(req[1], req[0], ByteOrder::LittleEndian);
+    const auto count = makeUInt16(req[3], req[2], ByteOrder::LittleEndian);
+    const auto bytes = resp.mid(1);
+
+    QModbusDataUnit data(type, address, count);
+    for(int i = 0; i < count; i++)
+    {
+        if(type == QModbusDataUnit::Coils || type == QModbusDataUnit::DiscreteInputs)
+            data.setValue(i, i / 8 < bytes.size() ? (quint8(bytes[i / 8]) >> (i % 8)) & 1 : 0);
+        else
+            data.setValue(i, 2 * i + 1 < bytes.size() ? makeUInt16(bytes[2 * i + 1], bytes[2 * i], ByteOrder::LittleEndian) : 0);
+    }
+    return data;
+}
+
+///
+/// \brief The Replay class
+/// Feeds a session through the same code a form runs for live traffic
+///
+class Replay
+{
+public:
+    explicit Replay(const Session& session)
+        :_session(session)
+    {
+        _dd.PointType = QModbusDataUnit::Invalid;
+
+        QModbusPdu lastRequest;
+        for(auto&& f : session.Frames)
+        {
+            auto msg = ModbusMessage::create(f.Adu, session.Protocol, QDateTime(), f.Request);
+
+            Traffic t;
+            t.Request = f.Request;
+            t.DeviceId = msg->deviceId();
+            t.TransactionId = session.Protocol == ModbusMessage::Tcp ? ((const QModbusAduTcp*)msg->adu())->transactionId() : 0;
+            t.Pdu = msg->adu()->pdu();
+            _traffic.append(t);
+
+            if(f.Request)
+            {
+                lastRequest = t.Pdu;
+                const auto data = t.Pdu.data();
+                if(_dd.PointType == QModbusDataUnit::Invalid && registerType(t.Pdu.functionCode()) != QModbusDataUnit::Invalid && data.size() >= 4)
+                {
+                    _dd.PointType = registerType(t.Pdu.functionCode());
+                    _dd.PointAddress = makeUInt16(data[1], data[0], ByteOrder::LittleEndian) + 1;
+                    _dd.Length = makeUInt16(data[3], data[2], ByteOrder::LittleEndian);
+                    _dd.DeviceId = t.DeviceId;
+                }
+            }
+            else
+            {
+                const auto data = decodeReadResponse(lastRequest, t.Pdu);
+                if(data.isValid()) _updates.append(data);
+            }
+
+            delete msg;
+        }
+
+        // like a form, only show the table it was set up for
+        _updates.erase(std::remove_if(_updates.begin(), _updates.end(), [this](const QModbusDataUnit& data) {
+            return data.registerType() != _dd.PointType;
+        }), _updates.end());
+
+        _result[0].Items = _result[1].Items = _result[2].Items = session.Frames.size();
+        _result[3].Items = _updates.size();
+    }
+
+    void run(const QString& captureFile)
+    {
+        const auto base = QDateTime::fromMSecsSinceEpoch(1700000000000);
+
+        // parse: raw frames into messages
+        {
+            Measure m(_result[0]);
+            for(auto&& f : _session.Frames)
+            {
+                auto msg = ModbusMessage::create(f.Adu, _session.Protocol, base.addMSecs(f.Offset / 1000), f.Request);
+                sink += msg->isValid();
+                delete msg;
+            }
+        }
+
+        // log: traffic into the log model, rendered as the view would
+        OutputWidget logWidget;
+        prepare(logWidget);
+        {
+            Measure m(_result[1]);
+            feedTraffic(logWidget);
+        }
+
+        // capture: the same with text capture on
+        OutputWidget captureWidget;
+        prepare(captureWidget);
+        captureWidget.startTextCapture(captureFile);
+        {
+            Measure m(_result[2]);
+            feedTraffic(captureWidget);
+        }
+        captureWidget.stopTextCapture();
+
+        // update: read responses into the output model, every row rendered
+        OutputWidget dataWidget;
+        prepare(dataWidget);
+        const auto model = dataWidget.findChild<OutputDataView*>("dataView")->model();
+        {
+            Measure m(_result[3]);
+            for(auto&& data : _updates)
+            {
+                dataWidget.updateData(data);
+                for(int row = 0; row < model->rowCount(); row++)
+                    sink += model->data(model->index(row, 0), Qt::DisplayRole).toString().size();
+            }
+        }
+    }
+
+    QString name() const {
+        return _session.Name;
+    }
+
+    const StageResult& result(int stage) const {
+        return _result[stage];
+    }
+
+private:
+    void prepare(OutputWidget& widget) const
+    {
+        widget.setup(_dd, _session.Protocol, ModbusSimulationMap());
+        widget.setDataDisplayMode(_session.Mode);
+    }
+
+    void feedTraffic(OutputWidget& widget) const
+    {
+        const auto logView = widget.findChild<ModbusLogWidget*>("logView");
+        for(auto&& t : _traffic)
+        {
+            if(t.Request)
+                widget.updateTraffic(QModbusRequest(t.Pdu), t.DeviceId, t.TransactionId);
+            else
+                widget.updateTraffic(QModbusResponse(t.Pdu), t.DeviceId, t.TransactionId);
+
+            sink += logView->model()->data(logView->index(logView->rowCount() - 1), Qt::DisplayRole).toString().size();
+        }
+    }
+
+private:
+    const Session& _session;
+    DisplayDefinition _dd;
+    QVector<Traffic> _traffic;
+    QVector<QModbusDataUnit> _updates;
+    StageResult _result[StageCount];
+};
+
+///
+/// \brief makeReport
+/// \param replays
+/// \param iterations
+/// \return
+///
+static QJsonObject makeReport(const QList<Replay*>& replays, int iterations)
+{
+    QJsonArray sessions;
+    for(auto&& r : replays)
+    {
+        QJsonObject stages;
+        for(int i = 0; i < StageCount; i++)
+        {
+            const auto& res = r->result(i);
+            stages[Stages[i]] = QJsonObject {
+                { "items", res.Items },
+                { "nsPerItem", qRound64(res.nsPerItem()) },
+                { "allocationsPerItem", res.allocationsPerItem() }
+            };
+        }
+        sessions.append(QJsonObject { { "name", r->name() }, { "stages", stages } });
+    }
+
+    return QJsonObject {
+        { "version", 1 },
+        { "iterations", iterations },
+        { "sessions", sessions }
+    };
+}
+
+///
+/// \brief compareReports
+/// \param report
+/// \param baseline
+/// \param threshold allowed slowdown in percent
+/// \return the regressions found
+///
+static QJsonArray compareReports(const QJsonObject& report, const QJsonObject& baseline, double threshold)
+{
+    QMap<QString, QJsonObject> baseSessions;
+    for(auto&& s : baseline["sessions"].toArray())
+        baseSessions[s.toObject()["name"].toString()] = s.toObject()["stages"].toObject();
+
+    const auto limit = 1.0 + threshold / 100.0;
+
+    QJsonArray regressions;
+    for(auto&& s : report["sessions"].toArray())
+    {
+        const auto name = s.toObject()["name"].toString();
+        if(!baseSessions.contains(name))
+            continue;
+
+        const auto stages = s.toObject()["stages"].toObject();
+        const auto baseStages = baseSessions[name];
+        for(auto&& stage : stages.keys())
+        {
+            if(!baseStages.contains(stage))
+                continue;
+
+            for(auto metric : { "nsPerItem", "allocationsPerItem" })
+            {
+                const auto current = stages[stage].toObject()[metric].toDouble();
+                const auto base = baseStages[stage].toObject()[metric].toDouble();
+
+                // ignore noise on metrics too small to matter
+                const bool regressed = (QLatin1String(metric) == QLatin1String("nsPerItem")) ?
+                                       current > base * limit :
+                                       current > base * limit && current - base >= 0.5;
+                if(!regressed)
+                    continue;
+
+                regressions.append(QJsonObject {
+                    { "session", name },
+                    { "stage", stage },
+                    { "metric", metric },
+                    { "baseline", base },
+                    { "current", current },
+                    { "ratio", base > 0 ? current / base : 0 }
+                });
+            }
+        }
+    }
+    return regressions;
+}
+
+///
+/// \brief readJson
+/// \param filename
+/// \param obj
+/// \return
+///
+static bool readJson(const QString& filename, QJsonObject& obj)
+{
+    QFile file(filename);
+    if(!file.open(QFile::ReadOnly))
+        return false;
+
+    const auto doc = QJsonDocument::fromJson(file.readAll());
+    obj = doc.object();
+    return doc.isObject();
+}
+
+///
+/// \brief writeJson
+/// \param filename empty for the standard output
+/// \param obj
+/// \return
+///
+static bool writeJson(const QString& filename, const QJsonObject& obj)
+{
+    QFile file;
+    const bool ok = filename.isEmpty() ?
+                    file.open(stdout, QFile::WriteOnly) :
+                    (file.setFileName(filename), file.open(QFile::WriteOnly | QFile::Truncate));
+
+    return ok && file.write(QJsonDocument(obj).toJson()) > 0;
+}
+
+///
+/// \brief main
+/// \param argc
+/// \param argv
+/// \return 0 on success, 1 on errors, 2 when a regression was found
+///
+int main(int argc, char* argv[])
+{
+    if(qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+
+    QApplication app(argc, argv);
+    app.setApplicationName("bench_replay");
+
+    // the same numbers on every machine
+    QLocale::setDefault(QLocale::c());
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Replays recorded MODBUS sessions through the parsing, logging and display code");
+    parser.addHelpOption();
+    parser.addPositionalArgument("corpus", "Directory with the *.session files.", "[corpus]");
+
+    const QCommandLineOption iterationsOption("iterations", "Number of runs per session, the best one is reported.", "count", "20");
+    const QCommandLineOption outputOption("output", "Write the JSON report to <file> instead of the standard output.", "file");
+    const QCommandLineOption baselineOption("baseline", "Compare against the report in <file>.", "file");
+    const QCommandLineOption saveBaselineOption("save-baseline", "Store this report as the baseline <file>.", "file");
+    const QCommandLineOption thresholdOption("threshold", "Allowed slowdown against the baseline in percent.", "percent", "20");
+    parser.addOptions({ iterationsOption, outputOption, baselineOption, saveBaselineOption, thresholdOption });
+    parser.process(app);
+
+    const auto corpusDir = parser.positionalArguments().value(0, REPLAY_CORPUS_DIR);
+    const auto iterations = qMax(1, parser.value(iterationsOption).toInt());
+    const auto threshold = parser.value(thresholdOption).toDouble();
+
+    QTextStream err(stderr);
+
+    QList<Session> sessions;
+    for(auto&& fi : QDir(corpusDir).entryInfoList({ "*.session" }, QDir::Files, QDir::Name))
+    {
+        Session session;
+        QString error;
+        if(!loadSession(fi.filePath(), session, error))
+        {
+            err << fi.fileName() << ": " << error << Qt::endl;
+            return 1;
+        }
+        sessions.append(session);
+    }
+
+    if(sessions.isEmpty())
+    {
+        err << "No sessions found in " << corpusDir << Qt::endl;
+        return 1;
+    }
+
+    QTemporaryDir tempDir;
+    const auto captureFile = tempDir.filePath("capture.txt");
+
+    QList<Replay*> replays;
+    for(auto&& s : sessions)
+    {
+        auto replay = new Replay(s);
+
+        // the first run warms up caches and lazily created Qt state
+        replay->run(captureFile);
+        for(int i = 0; i < iterations; i++)
+            replay->run(captureFile);
+
+        replays.append(replay);
+    }
+
+    auto report = makeReport(replays, iterations);
+
+    const QString rowFormat("%1 %2 %3 %4 %5");
+    err << rowFormat.arg("session", -22).arg("stage", -8).arg("items", 6).arg("ns/item", 10).arg("allocs/item", 12) << Qt::endl;
+    for(auto&& r : replays)
+    {
+        for(int i = 0; i < StageCount; i++)
+        {
+            const auto& res = r->result(i);
+            err << rowFormat.arg(r->name(), -22).arg(Stages[i], -8).arg(res.Items, 6)
+                            .arg(res.nsPerItem(), 10, 'f', 0).arg(res.allocationsPerItem(), 12, 'f', 1) << Qt::endl;
+        }
+    }
+    qDeleteAll(replays);
+
+    if(parser.isSet(saveBaselineOption) && !writeJson(parser.value(saveBaselineOption), report))
+    {
+        err << "Cannot write " << parser.value(saveBaselineOption) << Qt::endl;
+        return 1;
+    }
+
+    int ret = 0;
+    if(parser.isSet(baselineOption))
+    {
+        QJsonObject baseline;
+        if(!readJson(parser.value(baselineOption), baseline))
+        {
+            err << "Cannot read baseline " << parser.value(baselineOption) << Qt::endl;
+            return 1;
+        }
+
+        const auto regressions = compareReports(report, baseline, threshold);
+        report["threshold"] = threshold;
+        report["regressions"] = regressions;
+
+        for(auto&& r : regressions)
+        {
+            const auto obj = r.toObject();
+            err << "REGRESSION " << obj["session"].toString() << "/" << obj["stage"].toString() << " "
+                << obj["metric"].toString() << ": " << obj["baseline"].toDouble() << " -> " << obj["current"].toDouble() << Qt::endl;
+        }
+
+        if(!regressions.isEmpty())
+            ret = 2;
+    }
+
+    if(!writeJson(parser.value(outputOption), report))
+    {
+        err << "Cannot write the report" << Qt::endl;
+        return 1;
+    }
+
+    return ret;
+}
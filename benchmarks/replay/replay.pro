@@ -0,0 +1,61 @@
+QT += core gui widgets network serialbus serialport
+
+CONFIG += c++17 console
+CONFIG -= app_bundle
+CONFIG -= debug_and_release
+CONFIG -= debug_and_release_target
+
+TARGET = bench_replay
+
+SRC_DIR = $$PWD/../../omodscan
+
+DEFINES += REPLAY_CORPUS_DIR=\\\"$$PWD/corpus\\\"
+
+INCLUDEPATH += $$SRC_DIR \
+               $$SRC_DIR/controls \
+               $$SRC_DIR/dialogs \
+               $$SRC_DIR/modbusmessages \
+
+SOURCES += \
+    benchreplay.cpp \
+    $$SRC_DIR/controls/modbuslogwidget.cpp \
+    $$SRC_DIR/controls/modbusmessagewidget.cpp \
+    $$SRC_DIR/controls/outputdataview.cpp \
+    $$SRC_DIR/controls/outputwidget.cpp \
+    $$SRC_DIR/controls/sparklinewidget.cpp \
+    $$SRC_DIR/formatpipeline.cpp \
+    $$SRC_DIR/glyphcache.cpp \
+    $$SRC_DIR/htmldelegate.cpp \
+    $$SRC_DIR/memorybudget.cpp \
+    $$SRC_DIR/modbuslogdelegate.cpp \
+    $$SRC_DIR/modbusmessages/modbusmessage.cpp \
+    $$SRC_DIR/packedbits.cpp \
+    $$SRC_DIR/registerdecoder.cpp \
+    $$SRC_DIR/registerhistory.cpp \
+    $$SRC_DIR/requesttracer.cpp
+
+HEADERS += \
+    $$SRC_DIR/controls/modbuslogwidget.h \
+    $$SRC_DIR/controls/modbusmessagewidget.h \
+    $$SRC_DIR/controls/outputdataview.h \
+    $$SRC_DIR/controls/outputwidget.h \
+    $$SRC_DIR/controls/sparklinewidget.h \
+    $$SRC_DIR/fastformat.h \
+    $$SRC_DIR/formatpipeline.h \
+    $$SRC_DIR/formatutils.h \
+    $$SRC_DIR/glyphcache.h \
+    $$SRC_DIR/htmldelegate.h \
+    $$SRC_DIR/memorybudget.h \
+    $$SRC_DIR/modbuslogdelegate.h \
+    $$SRC_DIR/numericutils.h \
+    $$SRC_DIR/packedbits.h \
+    $$SRC_DIR/qmodbusadurtu.h \
+    $$SRC_DIR/registerdecoder.h \
+    $$SRC_DIR/registerhistory.h \
+    $$SRC_DIR/requesttracer.h
+
+FORMS += \
+    $$SRC_DIR/controls/outputwidget.ui
+
+OTHER_FILES += \
+    corpus/*.session
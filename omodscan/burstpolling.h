@@ -0,0 +1,175 @@
+#ifndef BURSTPOLLING_H
+#define BURSTPOLLING_H
+
+#include <QtMath>
+#include <QVector>
+#include <QMetaType>
+
+///
+/// \brief The BurstPollingMode enum
+///
+enum class BurstPollingMode
+{
+    Duration = 0,
+    Samples
+};
+Q_DECLARE_METATYPE(BurstPollingMode);
+
+///
+/// \brief The BurstPollingError enum
+/// Why a burst did not start
+///
+enum class BurstPollingError
+{
+    NoError = 0,
+    NotConnected,
+    InvalidRange,
+    AlreadyActive,
+    RequestFailed
+};
+
+///
+/// \brief The BurstPollingParams struct
+///
+struct BurstPollingParams
+{
+    BurstPollingMode Mode = BurstPollingMode::Duration;
+    quint32 Duration = 10000;
+    quint32 Samples = 1000;
+
+    void normalize()
+    {
+        Mode = qBound(BurstPollingMode::Duration, Mode, BurstPollingMode::Samples);
+        Duration = qBound(100U, Duration, 3600000U);
+        Samples = qBound(1U, Samples, 1000000U);
+    }
+};
+Q_DECLARE_METATYPE(BurstPollingParams)
+
+///
+/// \brief The BurstSample struct
+///
+struct BurstSample
+{
+    qint64 RequestTime = 0;  ///< nanoseconds since the burst started
+    qint64 ResponseTime = 0; ///< nanoseconds since the burst started
+    bool Valid = false;
+
+    qint64 roundTripTime() const {
+        return ResponseTime - RequestTime;
+    }
+};
+Q_DECLARE_TYPEINFO(BurstSample, Q_PRIMITIVE_TYPE);
+
+///
+/// \brief The BurstPollingResult struct
+///
+struct BurstPollingResult
+{
+    QVector<BurstSample> Samples;
+
+    ///
+    /// \brief validSamples
+    /// \return
+    ///
+    int validSamples() const
+    {
+        int valid = 0;
+        for(auto&& s : Samples)
+            if(s.Valid) valid++;
+        return valid;
+    }
+
+    ///
+    /// \brief elapsed
+    /// \return nanoseconds from the first request to the last response
+    ///
+    qint64 elapsed() const
+    {
+        if(Samples.isEmpty()) return 0;
+        return Samples.last().ResponseTime - Samples.first().RequestTime;
+    }
+
+    ///
+    /// \brief samplesPerSecond
+    /// \return
+    ///
+    double samplesPerSecond() const
+    {
+        const auto ns = elapsed();
+        return ns > 0 ? Samples.size() * 1e9 / ns : 0;
+    }
+
+    ///
+    /// \brief meanRoundTripTime
+    /// \return nanoseconds
+    ///
+    double meanRoundTripTime() const
+    {
+        if(Samples.isEmpty()) return 0;
+
+        double sum = 0;
+        for(auto&& s : Samples)
+            sum += s.roundTripTime();
+        return sum / Samples.size();
+    }
+
+    ///
+    /// \brief meanInterval
+    /// \return mean time between consecutive responses, nanoseconds
+    ///
+    double meanInterval() const
+    {
+        if(Samples.size() < 2) return 0;
+        return double(Samples.last().ResponseTime - Samples.first().ResponseTime) / (Samples.size() - 1);
+    }
+
+    ///
+    /// \brief minInterval
+    /// \return nanoseconds
+    ///
+    qint64 minInterval() const
+    {
+        qint64 result = 0;
+        for(int i = 1; i < Samples.size(); i++)
+        {
+            const auto interval = Samples[i].ResponseTime - Samples[i - 1].ResponseTime;
+            result = (i == 1) ? interval : qMin(result, interval);
+        }
+        return result;
+    }
+
+    ///
+    /// \brief maxInterval
+    /// \return nanoseconds
+    ///
+    qint64 maxInterval() const
+    {
+        qint64 result = 0;
+        for(int i = 1; i < Samples.size(); i++)
+            result = qMax(result, Samples[i].ResponseTime - Samples[i - 1].ResponseTime);
+        return result;
+    }
+
+    ///
+    /// \brief jitter
+    /// \return standard deviation of the inter-sample interval, nanoseconds
+    ///
+    double jitter() const
+    {
+        if(Samples.size() < 3) return 0;
+
+        const auto mean = meanInterval();
+
+        double sum = 0;
+        for(int i = 1; i < Samples.size(); i++)
+        {
+            const auto d = (Samples[i].ResponseTime - Samples[i - 1].ResponseTime) - mean;
+            sum += d * d;
+        }
+        return qSqrt(sum / (Samples.size() - 1));
+    }
+};
+Q_DECLARE_METATYPE(BurstPollingResult)
+
+#endif // BURSTPOLLING_H
@@ -41,7 +41,9 @@ inline QString Parity_toString(QSerialPort::Parity parity)
 ///
 MainStatusBar::MainStatusBar(const ModbusClient& client, QMdiArea* parent)
     : QStatusBar(parent)
+    ,_client(client)
     ,_mdiArea(parent)
+    ,_eventLoopMonitorEnabled(true)
 {
     Q_ASSERT(_mdiArea != nullptr);
 
@@ -57,14 +59,34 @@ MainStatusBar::MainStatusBar(const ModbusClient& client, QMdiArea* parent)
     _labelResps->setFrameShape(QFrame::Panel);
     _labelResps->setMinimumWidth(120);
 
+    _labelThroughput = new QLabel(this);
+    _labelThroughput->setVisible(false);
+
+    _sparkline = new SparklineWidget(this);
+    _sparkline->setVisible(false);
+
+    _labelEventLoop = new QLabel(this);
+    _labelEventLoop->setFrameShadow(QFrame::Sunken);
+    _labelEventLoop->setFrameShape(QFrame::Panel);
+    _labelEventLoop->setVisible(false);
+
+    addPermanentWidget(_labelThroughput);
+    addPermanentWidget(_sparkline);
     addPermanentWidget(_labelPolls);
     addPermanentWidget(_labelResps);
+    addPermanentWidget(_labelEventLoop);
 
     _labelConnectionDetails = new QLabel(this);
     _labelConnectionDetails->setVisible(false);
 
     addWidget(_labelConnectionDetails);
 
+    _throughputMeter = new ThroughputMeter(client, this);
+    connect(_throughputMeter, &ThroughputMeter::updated, this, &MainStatusBar::updateThroughput);
+
+    _eventLoopMonitor = new EventLoopMonitor(this);
+    connect(_eventLoopMonitor, &EventLoopMonitor::updated, this, &MainStatusBar::updateEventLoop);
+
     connect(&client, &ModbusClient::modbusConnecting, this, [&](const ConnectionDetails& cd)
     {
         updateConnectionInfo(cd, true);
@@ -73,12 +95,14 @@ MainStatusBar::MainStatusBar(const ModbusClient& client, QMdiArea* parent)
     connect(&client, &ModbusClient::modbusConnected, this, [&](const ConnectionDetails& cd)
     {
         updateConnectionInfo(cd, false);
+        updateEventLoopProbe();
     });
 
     connect(&client, &ModbusClient::modbusDisconnected, this, [&](const ConnectionDetails&)
     {
         _labelConnectionDetails->setText(QString());
         _labelConnectionDetails->setVisible(false);
+        updateEventLoopProbe();
     });
 }
 
@@ -90,6 +114,9 @@ MainStatusBar::~MainStatusBar()
     delete _labelPolls;
     delete _labelResps;
     delete _labelConnectionDetails;
+    delete _labelThroughput;
+    delete _sparkline;
+    delete _labelEventLoop;
 }
 
 ///
@@ -109,6 +136,9 @@ void MainStatusBar::changeEvent(QEvent* event)
             const auto cd = _labelConnectionDetails->property("ConnectionDetails").value<ConnectionDetails>();
             updateConnectionInfo(cd, connecting);
        }
+
+       updateThroughput();
+       updateEventLoop();
     }
 
     QStatusBar::changeEvent(event);
@@ -176,3 +206,133 @@ void MainStatusBar::updateConnectionInfo(const ConnectionDetails& cd, bool conne
     _labelConnectionDetails->setText(info);
     _labelConnectionDetails->setVisible(true);
 }
+
+///
+/// \brief formatBytes
+/// \param bytes
+/// \return
+///
+static QString formatBytes(double bytes)
+{
+    return bytes < 10240 ? QString(MainStatusBar::tr("%1 B/s")).arg(qRound(bytes)) :
+                           QString(MainStatusBar::tr("%1 KB/s")).arg(bytes / 1024, 0, 'f', 1);
+}
+
+///
+/// \brief MainStatusBar::updateThroughput
+///
+void MainStatusBar::updateThroughput()
+{
+    const auto history = _throughputMeter->requestsHistory();
+    if(history.isEmpty())
+    {
+        _labelThroughput->setVisible(false);
+        _sparkline->setVisible(false);
+        return;
+    }
+
+    const auto s = _throughputMeter->current();
+    auto text = QString(tr("Req/s: %1  Resp/s: %2  Tx: %3  Rx: %4")).arg(QString::number(s.Requests, 'f', 1),
+                                                                         QString::number(s.Responses, 'f', 1),
+                                                                         formatBytes(s.TxBytes),
+                                                                         formatBytes(s.RxBytes));
+    if(s.Timeouts > 0 || s.Exceptions > 0)
+        text += QString(tr("  Timeouts/s: %1  Exceptions/s: %2")).arg(QString::number(s.Timeouts, 'f', 1),
+                                                                        QString::number(s.Exceptions, 'f', 1));
+
+    if(_throughputMeter->isSerial())
+    {
+        text += QString(tr("  Bus: %1%")).arg(QString::number(s.Utilisation * 100, 'f', 1));
+        _sparkline->setMaximum(1);
+        _sparkline->setValues(_throughputMeter->utilisationHistory());
+        _sparkline->setToolTip(tr("Line utilisation, last %1 s").arg(history.size()));
+    }
+    else
+    {
+        _sparkline->setMaximum(0);
+        _sparkline->setValues(history);
+        _sparkline->setToolTip(tr("Requests per second, last %1 s").arg(history.size()));
+    }
+
+    _labelThroughput->setText(text);
+    _labelThroughput->setVisible(true);
+    _sparkline->setVisible(true);
+}
+
+///
+/// \brief MainStatusBar::showEvent
+/// \param event
+///
+void MainStatusBar::showEvent(QShowEvent* event)
+{
+    QStatusBar::showEvent(event);
+    updateEventLoopProbe();
+}
+
+///
+/// \brief MainStatusBar::hideEvent
+/// The status bar is hidden with a minimised window too
+/// \param event
+///
+void MainStatusBar::hideEvent(QHideEvent* event)
+{
+    QStatusBar::hideEvent(event);
+    updateEventLoopProbe();
+}
+
+///
+/// \brief MainStatusBar::eventLoopMonitorEnabled
+/// \return
+///
+bool MainStatusBar::eventLoopMonitorEnabled() const
+{
+    return _eventLoopMonitorEnabled;
+}
+
+///
+/// \brief MainStatusBar::setEventLoopMonitorEnabled
+/// \param on
+///
+void MainStatusBar::setEventLoopMonitorEnabled(bool on)
+{
+    _eventLoopMonitorEnabled = on;
+    updateEventLoopProbe();
+}
+
+///
+/// \brief MainStatusBar::updateEventLoopProbe
+/// The probe only runs while a connection is open and its figures can be seen
+///
+void MainStatusBar::updateEventLoopProbe()
+{
+    const bool run = _eventLoopMonitorEnabled && isVisible() && !window()->isMinimized() &&
+                     _client.state() == QModbusDevice::ConnectedState;
+
+    if(run)
+    {
+        _eventLoopMonitor->start();
+    }
+    else
+    {
+        _eventLoopMonitor->stop();
+        _labelEventLoop->setVisible(false);
+    }
+}
+
+///
+/// \brief MainStatusBar::updateEventLoop
+///
+void MainStatusBar::updateEventLoop()
+{
+    const auto& h = _eventLoopMonitor->histogram();
+    if(h.count() == 0)
+        return;
+
+    const auto msecs = [](qint64 usecs) { return QString::number(usecs / 1000.0, 'f', 1); };
+
+    _labelEventLoop->setText(QString(tr("Loop p99: %1 ms")).arg(msecs(h.percentile(99))));
+    _labelEventLoop->setToolTip(QString(tr("Event loop latency, last %1 s\np50: %2 ms\np95: %3 ms\np99: %4 ms\nmax: %5 ms"))
+                                    .arg(QString::number(EventLoopMonitor::WindowSize / 1000), msecs(h.percentile(50)),
+                                         msecs(h.percentile(95)), msecs(h.percentile(99)), msecs(h.max())));
+    _labelEventLoop->setVisible(true);
+}
@@ -5,6 +5,9 @@
 #include <QStatusBar>
 #include <QMdiArea>
 #include "modbusclient.h"
+#include "throughputmeter.h"
+#include "eventloopmonitor.h"
+#include "sparklinewidget.h"
 
 ///
 /// \brief The MainStatusBar class
@@ -19,17 +22,32 @@ public:
     void updateNumberOfPolls();
     void updateValidSlaveResponses();
 
+    bool eventLoopMonitorEnabled() const;
+    void setEventLoopMonitorEnabled(bool on);
+
 protected:
     void changeEvent(QEvent* event) override;
+    void showEvent(QShowEvent* event) override;
+    void hideEvent(QHideEvent* event) override;
 
 private:
     void updateConnectionInfo(const ConnectionDetails& cd, bool connecting);
+    void updateThroughput();
+    void updateEventLoop();
+    void updateEventLoopProbe();
 
 private:
+    const ModbusClient& _client;
     QMdiArea* _mdiArea;
     QLabel* _labelPolls;
     QLabel* _labelResps;
     QLabel* _labelConnectionDetails;
+    QLabel* _labelThroughput;
+    SparklineWidget* _sparkline;
+    ThroughputMeter* _throughputMeter;
+    QLabel* _labelEventLoop;
+    EventLoopMonitor* _eventLoopMonitor;
+    bool _eventLoopMonitorEnabled;
 };
 
 #endif // MAINSTATUSBAR_H
@@ -1,6 +1,13 @@
 #include <QEvent>
-#include "htmldelegate.h"
+#include <cstring>
+#include "memorybudget.h"
 #include "modbuslogwidget.h"
+#include "modbuslogdelegate.h"
+
+///
+/// \brief DefaultRowLimit
+///
+static constexpr int DefaultRowLimit = 30;
 
 ///
 /// \brief ModbusLogModel::ModbusLogModel
@@ -10,6 +17,7 @@ ModbusLogModel::ModbusLogModel(ModbusLogWidget* parent)
     : QAbstractListModel(parent)
     ,_parentWidget(parent)
 {
+    _entries.resize(DefaultRowLimit);
 }
 
 ///
@@ -27,7 +35,7 @@ ModbusLogModel::~ModbusLogModel()
 ///
 int ModbusLogModel::rowCount(const QModelIndex&) const
 {
-    return _items.size();
+    return _count;
 }
 
 ///
@@ -41,21 +49,94 @@ QVariant ModbusLogModel::data(const QModelIndex& index, int role) const
     if(!index.isValid() || index.row() >= rowCount())
         return QVariant();
 
-    const auto& item = _items.at(index.row());
+    const auto row = index.row();
     switch(role)
     {
         case Qt::DisplayRole:
-            return QString("<b>%1</b> %2 %3").arg(item->timestamp().toString(Qt::ISODateWithMs),
-                                                  (item->isRequest()?  "&larr;" : "&rarr;"),
-                                                  item->toString(_parentWidget->dataDisplayMode()));
+            return QString("<b>%1</b> %2 %3").arg(timestamp(row).toString(Qt::ISODateWithMs),
+                                                  (isRequest(row)?  "&larr;" : "&rarr;"),
+                                                  toString(row, _parentWidget->dataDisplayMode()));
 
         case Qt::UserRole:
-            return QVariant::fromValue(item);
+            return QVariant::fromValue(message(row));
     }
 
     return QVariant();
 }
 
+///
+/// \brief ModbusLogModel::timestamp
+/// \param row
+/// \return
+///
+QDateTime ModbusLogModel::timestamp(int row) const
+{
+    return QDateTime::fromMSecsSinceEpoch(entry(row).Timestamp);
+}
+
+///
+/// \brief ModbusLogModel::isRequest
+/// \param row
+/// \return
+///
+bool ModbusLogModel::isRequest(int row) const
+{
+    return entry(row).Request;
+}
+
+///
+/// \brief ModbusLogModel::rawData
+/// \param row
+/// \return the frame of the row, it refers to the entry and must not outlive it
+///
+QByteArray ModbusLogModel::rawData(int row) const
+{
+    const auto& e = entry(row);
+    return QByteArray::fromRawData(e.Frame, e.Size);
+}
+
+///
+/// \brief ModbusLogModel::toString
+/// \param row
+/// \param mode
+/// \return the bytes of the frame as ModbusMessage::toString shows them
+///
+QString ModbusLogModel::toString(int row, DataDisplayMode mode) const
+{
+    return formatUInt8Array(mode, rawData(row));
+}
+
+///
+/// \brief ModbusLogModel::message
+/// Makes the message of the row the first time it is asked for, it lives as long as the row
+/// \param row
+/// \return
+///
+const ModbusMessage* ModbusLogModel::message(int row) const
+{
+    const auto& e = entry(row);
+    if(e.Message == nullptr)
+    {
+        e.Message = ModbusMessage::create(QByteArray(e.Frame, e.Size), e.Protocol, timestamp(row), e.Request);
+
+        const auto size = ModbusMessage::estimateMemoryUsage(e.Size);
+        _memoryUsage += size;
+        MemoryBudget::instance().allocate(size);
+    }
+
+    return e.Message;
+}
+
+///
+/// \brief ModbusLogModel::cachedMessage
+/// \param row
+/// \return the message of the row if it has been made, nullptr otherwise
+///
+const ModbusMessage* ModbusLogModel::cachedMessage(int row) const
+{
+    return entry(row).Message;
+}
+
 ///
 /// \brief ModbusLogModel::clear
 ///
@@ -66,23 +147,88 @@ void ModbusLogModel::clear()
     endResetModel();
 }
 
+///
+/// \brief writeFrame
+/// Lays the ADU out the way ModbusMessage does
+/// \param frame
+/// \param pdu
+/// \param protocol
+/// \param deviceId
+/// \param transactionId
+/// \param maxSize
+/// \return the size of the frame
+///
+static int writeFrame(char* frame, const QModbusPdu& pdu, ModbusMessage::ProtocolType protocol, int deviceId, int transactionId, int maxSize)
+{
+    const quint8 funcCode = pdu.isException() ? (pdu.functionCode() | QModbusPdu::ExceptionByte) : pdu.functionCode();
+    const auto data = pdu.data();
+
+    int n = 0;
+    if(protocol == ModbusMessage::Tcp)
+    {
+        const int length = data.size() + 2;
+        frame[n++] = char(transactionId >> 8);
+        frame[n++] = char(transactionId);
+        frame[n++] = 0;
+        frame[n++] = 0;
+        frame[n++] = char(length >> 8);
+        frame[n++] = char(length);
+    }
+
+    frame[n++] = char(deviceId);
+    frame[n++] = char(funcCode);
+
+    const int dataSize = qMin<int>(data.size(), maxSize - n - (protocol == ModbusMessage::Rtu ? 2 : 0));
+    memcpy(frame + n, data.constData(), dataSize);
+    n += dataSize;
+
+    if(protocol == ModbusMessage::Rtu)
+    {
+        const auto crc = QModbusAduRtu::calculateCRC(frame, n);
+        frame[n++] = char(crc >> 8);
+        frame[n++] = char(crc);
+    }
+
+    return n;
+}
+
 ///
 /// \brief ModbusLogModel::append
-/// \param data
+/// Writes the frame into the next entry of the ring, the oldest entry is reused when the ring is full
+/// \param pdu
+/// \param protocol
+/// \param deviceId
+/// \param transactionId
+/// \param timestamp
+/// \param request
+/// \return
 ///
-void ModbusLogModel::append(const ModbusMessage* data)
+bool ModbusLogModel::append(const QModbusPdu& pdu, ModbusMessage::ProtocolType protocol, int deviceId, int transactionId, const QDateTime& timestamp, bool request)
 {
-    if(data == nullptr) return;
+    if(_entries.isEmpty())
+        return false;
 
-    while(rowCount() >= _rowLimit)
+    const qint64 size = sizeof(LogEntry);
+    while(_count >= _entries.size() ||
+          (_count > 0 && MemoryBudget::instance().wouldExceed(size)))
     {
-        delete _items.first();
-        _items.removeFirst();
+        removeFirst();
     }
 
-    beginInsertRows(QModelIndex(), rowCount(), rowCount());
-    _items.push_back(data);
+    beginInsertRows(QModelIndex(), _count, _count);
+
+    auto& e = _entries[(_first + _count) % _entries.size()];
+    e.Timestamp = timestamp.toMSecsSinceEpoch();
+    e.Protocol = protocol;
+    e.Request = request;
+    e.Size = writeFrame(e.Frame, pdu, protocol, deviceId, transactionId, MaxFrameSize);
+    _count++;
+
+    _memoryUsage += size;
+    MemoryBudget::instance().allocate(size);
     endInsertRows();
+
+    return true;
 }
 
 ///
@@ -91,16 +237,61 @@ void ModbusLogModel::append(const ModbusMessage* data)
 ///
 int ModbusLogModel::rowLimit() const
 {
-    return _rowLimit;
+    return _entries.size();
 }
 
 ///
 /// \brief ModbusLogModel::setRowLimit
+/// Resizes the ring, the newest entries that fit are kept
 /// \param val
 ///
 void ModbusLogModel::setRowLimit(int val)
 {
-    _rowLimit = qMax(1, val);
+    val = qMax(1, val);
+    if(val == _entries.size())
+        return;
+
+    while(_count > val)
+        removeFirst();
+
+    QVector<LogEntry> entries(val);
+    for(int row = 0; row < _count; row++)
+        entries[row] = entry(row);
+
+    _entries.swap(entries);
+    _first = 0;
+}
+
+///
+/// \brief ModbusLogModel::removeFirst
+/// Drops the oldest entry
+///
+void ModbusLogModel::removeFirst()
+{
+    beginRemoveRows(QModelIndex(), 0, 0);
+    releaseEntry(_entries[_first]);
+    _first = (_first + 1) % _entries.size();
+    _count--;
+    endRemoveRows();
+}
+
+///
+/// \brief ModbusLogModel::releaseEntry
+/// Deletes the message made for the entry and gives its memory back to the budget
+/// \param e
+///
+void ModbusLogModel::releaseEntry(LogEntry& e)
+{
+    qint64 size = sizeof(LogEntry);
+    if(e.Message != nullptr)
+    {
+        size += ModbusMessage::estimateMemoryUsage(e.Size);
+        delete e.Message;
+        e.Message = nullptr;
+    }
+
+    _memoryUsage -= size;
+    MemoryBudget::instance().release(size);
 }
 
 ///
@@ -108,10 +299,11 @@ void ModbusLogModel::setRowLimit(int val)
 ///
 void ModbusLogModel::deleteItems()
 {
-    for(auto&& i : _items)
-        delete i;
+    for(int row = 0; row < _count; row++)
+        releaseEntry(_entries[(_first + row) % _entries.size()]);
 
-    _items.clear();
+    _first = 0;
+    _count = 0;
 }
 
 ///
@@ -122,7 +314,7 @@ ModbusLogWidget::ModbusLogWidget(QWidget* parent)
     : QListView(parent)
     , _autoscroll(false)
 {
-    setItemDelegate(new HtmlDelegate(this));
+    setItemDelegate(new ModbusLogDelegate(this));
     setModel(new ModbusLogModel(this));
 
     connect(model(), &ModbusLogModel::rowsInserted,
@@ -181,20 +373,14 @@ QModelIndex ModbusLogWidget::index(int row)
 /// \param transactionId
 /// \param timestamp
 /// \param request
-/// \return
+/// \return the index of the new item
 ///
-const ModbusMessage* ModbusLogWidget::addItem(const QModbusPdu& pdu, ModbusMessage::ProtocolType protocol, int deviceId, int transactionId, const QDateTime& timestamp, bool request)
+QModelIndex ModbusLogWidget::addItem(const QModbusPdu& pdu, ModbusMessage::ProtocolType protocol, int deviceId, int transactionId, const QDateTime& timestamp, bool request)
 {
-    const ModbusMessage* msg = nullptr;
-    if(model())
-    {
-        msg = ModbusMessage::create(pdu, protocol, deviceId, timestamp, request);
-        if(protocol == ModbusMessage::Tcp)
-            ((QModbusAduTcp*)msg->adu())->setTransactionId(transactionId);
+    if(!model() || !((ModbusLogModel*)model())->append(pdu, protocol, deviceId, transactionId, timestamp, request))
+        return QModelIndex();
 
-        ((ModbusLogModel*)model())->append(msg);
-    }
-    return msg;
+    return index(rowCount() - 1);
 }
 
 ///
@@ -212,6 +398,33 @@ const ModbusMessage* ModbusLogWidget::itemAt(const QModelIndex& index)
            nullptr;
 }
 
+///
+/// \brief ModbusLogWidget::cachedItemAt
+/// \param index
+/// \return the message of the item if it has been made by itemAt, nullptr otherwise
+///
+const ModbusMessage* ModbusLogWidget::cachedItemAt(const QModelIndex& index)
+{
+    if(!index.isValid() || !model())
+        return nullptr;
+
+    return ((ModbusLogModel*)model())->cachedMessage(index.row());
+}
+
+///
+/// \brief ModbusLogWidget::itemText
+/// \param index
+/// \param mode
+/// \return the bytes of the item as ModbusMessage::toString shows them
+///
+QString ModbusLogWidget::itemText(const QModelIndex& index, DataDisplayMode mode)
+{
+    if(!index.isValid() || !model())
+        return QString();
+
+    return ((ModbusLogModel*)model())->toString(index.row(), mode);
+}
+
 ///
 /// \brief ModbusLogWidget::dataDisplayMode
 /// \return
@@ -254,6 +467,15 @@ void ModbusLogWidget::setRowLimit(int val)
     }
 }
 
+///
+/// \brief ModbusLogWidget::memoryUsage
+/// \return approximate number of bytes held by the log entries
+///
+qint64 ModbusLogWidget::memoryUsage() const
+{
+    return model() ? ((ModbusLogModel*)model())->memoryUsage() : 0;
+}
+
 ///
 /// \brief ModbusLogWidget::autoscroll
 /// \return
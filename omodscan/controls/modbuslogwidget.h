@@ -1,7 +1,7 @@
 #ifndef MODBUSLOGWIDGET_H
 #define MODBUSLOGWIDGET_H
 
-#include <QQueue>
+#include <QVector>
 #include <QListView>
 #include "modbusmessage.h"
 
@@ -9,6 +9,9 @@ class ModbusLogWidget;
 
 ///
 /// \brief The ModbusLogModel class
+/// Keeps the log in a ring of fixed size entries that are reused in place.
+/// An entry holds the frame bytes, so logging a message allocates nothing;
+/// the message object is only made when it is asked for.
 ///
 class  ModbusLogModel : public QAbstractListModel
 {
@@ -22,21 +25,54 @@ public:
     QVariant data(const QModelIndex& index, int role) const override;
 
     void clear();
-    void append(const ModbusMessage* data);
+    bool append(const QModbusPdu& pdu, ModbusMessage::ProtocolType protocol, int deviceId, int transactionId, const QDateTime& timestamp, bool request);
     void update(){
-        emit dataChanged(index(0), index(_items.size() - 1));
+        emit dataChanged(index(0), index(_count - 1));
     }
 
+    QDateTime timestamp(int row) const;
+    bool isRequest(int row) const;
+    QByteArray rawData(int row) const;
+    QString toString(int row, DataDisplayMode mode) const;
+
+    const ModbusMessage* message(int row) const;
+    const ModbusMessage* cachedMessage(int row) const;
+
     int rowLimit() const;
     void setRowLimit(int val);
 
+    qint64 memoryUsage() const {
+        return _memoryUsage;
+    }
+
 private:
+    // MBAP header and the largest PDU
+    static constexpr int MaxFrameSize = 7 + 253;
+
+    struct LogEntry
+    {
+        qint64 Timestamp = 0;
+        mutable const ModbusMessage* Message = nullptr;
+        ModbusMessage::ProtocolType Protocol = ModbusMessage::Rtu;
+        bool Request = false;
+        quint16 Size = 0;
+        char Frame[MaxFrameSize];
+    };
+
+    const LogEntry& entry(int row) const {
+        return _entries[(_first + row) % _entries.size()];
+    }
+
+    void removeFirst();
+    void releaseEntry(LogEntry& e);
     void deleteItems();
 
 private:
-    int _rowLimit = 30;
+    int _first = 0;
+    int _count = 0;
+    mutable qint64 _memoryUsage = 0;
     ModbusLogWidget* _parentWidget;
-    QQueue<const ModbusMessage*> _items;
+    QVector<LogEntry> _entries;
 };
 
 ///
@@ -53,8 +89,10 @@ public:
     int rowCount() const;
     QModelIndex index(int row);
 
-    const ModbusMessage* addItem(const QModbusPdu& pdu, ModbusMessage::ProtocolType protocol, int deviceId, int transactionId, const QDateTime& timestamp, bool request);
+    QModelIndex addItem(const QModbusPdu& pdu, ModbusMessage::ProtocolType protocol, int deviceId, int transactionId, const QDateTime& timestamp, bool request);
     const ModbusMessage* itemAt(const QModelIndex& index);
+    const ModbusMessage* cachedItemAt(const QModelIndex& index);
+    QString itemText(const QModelIndex& index, DataDisplayMode mode);
 
     DataDisplayMode dataDisplayMode() const;
     void setDataDisplayMode(DataDisplayMode mode);
@@ -62,6 +100,8 @@ public:
     int rowLimit() const;
     void setRowLimit(int val);
 
+    qint64 memoryUsage() const;
+
     bool autoscroll() const;
     void setAutoscroll(bool on);
 
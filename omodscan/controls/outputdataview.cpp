@@ -0,0 +1,544 @@
+#include <algorithm>
+#include <utility>
+#include <QStyle>
+#include <QPainter>
+#include <QCoreApplication>
+#include <QScrollBar>
+#include <QWheelEvent>
+#include <QPaintEvent>
+#include <QToolTip>
+#include "outputwidget.h"
+#include "formatutils.h"
+#include "glyphcache.h"
+#include "sparklinewidget.h"
+#include "outputdataview.h"
+
+///
+/// \brief CellPadding
+///
+static constexpr int CellPadding = 2;
+
+///
+/// \brief SparklineChars
+/// Width of the sparkline in characters
+///
+static constexpr int SparklineChars = 10;
+
+///
+/// \brief GroupBits
+/// The bits of a grid cell are set apart in bytes
+///
+static constexpr int GroupBits = 8;
+
+///
+/// \brief valueChars
+/// \param mode
+/// \return the number of characters of the longest value text of a mode
+///
+static int valueChars(DataDisplayMode mode)
+{
+    switch(mode)
+    {
+        case DataDisplayMode::Binary:
+            return 18;
+
+        case DataDisplayMode::UInt16:
+        case DataDisplayMode::Int16:
+        case DataDisplayMode::Hex:
+            return 8;
+
+        case DataDisplayMode::FloatingPt:
+        case DataDisplayMode::SwappedFP:
+            return 13;
+
+        case DataDisplayMode::Int32:
+        case DataDisplayMode::SwappedInt32:
+        case DataDisplayMode::UInt32:
+        case DataDisplayMode::SwappedUInt32:
+            return 12;
+
+        case DataDisplayMode::DblFloat:
+        case DataDisplayMode::SwappedDbl:
+            return 23;
+
+        default:
+            return 22;
+    }
+}
+
+///
+/// \brief OutputDataView::OutputDataView
+/// \param parent
+///
+OutputDataView::OutputDataView(QWidget* parent)
+    : QAbstractScrollArea(parent)
+    ,_model(nullptr)
+    ,_mode(DataDisplayMode::Binary)
+    ,_rowCount(0)
+    ,_iconSize(16)
+    ,_textWidth(0)
+    ,_showHistory(false)
+    ,_sparklineWidth(0)
+    ,_bitsPerCell(0)
+    ,_bitSize(0)
+    ,_groupGap(0)
+    ,_addressWidth(0)
+{
+    setVerticalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
+    setHorizontalScrollBarPolicy(Qt::ScrollBarAsNeeded);
+    viewport()->setBackgroundRole(QPalette::Base);
+    viewport()->setAutoFillBackground(true);
+
+    updateCellMetrics();
+}
+
+///
+/// \brief OutputDataView::setModel
+/// \param model
+///
+void OutputDataView::setModel(OutputListModel* model)
+{
+    if(_model)
+        disconnect(_model, nullptr, this, nullptr);
+
+    _model = model;
+
+    if(_model)
+    {
+        connect(_model, &QAbstractItemModel::dataChanged, this, &OutputDataView::on_dataChanged);
+        connect(_model, &QAbstractItemModel::modelReset, this, &OutputDataView::updateCellMetrics);
+        connect(_model, &OutputListModel::columnsReset, this, &OutputDataView::updateCellMetrics);
+    }
+
+    updateCellMetrics();
+}
+
+///
+/// \brief OutputDataView::rowAt
+/// \param pos position in the viewport
+/// \return the row of the cell at the position, -1 if there is none
+///
+int OutputDataView::rowAt(const QPoint& pos) const
+{
+    const int rows = rowsPerColumn();
+    const int x = pos.x() + horizontalScrollBar()->value();
+    if(x < 0 || pos.y() < 0)
+        return -1;
+
+    const int r = pos.y() / _cellSize.height();
+    if(r >= rows)
+        return -1;
+
+    const int cell = x / _cellSize.width() * rows + r;
+    if(cell >= cellCount())
+        return -1;
+
+    if(_bitsPerCell <= 0)
+        return cell;
+
+    const int bit = bitAt(x % _cellSize.width());
+    const int row = cell * _bitsPerCell + bit;
+    return (bit >= 0 && row < _rowCount) ? row : -1;
+}
+
+///
+/// \brief OutputDataView::indexAt
+/// \param pos position in the viewport
+/// \return
+///
+QModelIndex OutputDataView::indexAt(const QPoint& pos) const
+{
+    const int row = rowAt(pos);
+    return (_model && row >= 0) ? _model->index(row) : QModelIndex();
+}
+
+///
+/// \brief OutputDataView::paintEvent
+/// \param event
+///
+void OutputDataView::paintEvent(QPaintEvent* event)
+{
+    if(!_model || _rowCount <= 0)
+        return;
+
+    const auto rc = event->rect();
+    const int x0 = horizontalScrollBar()->value();
+    const int rows = rowsPerColumn();
+    const int cx = _cellSize.width();
+    const int cy = _cellSize.height();
+
+    const int firstColumn = (rc.left() + x0) / cx;
+    const int lastColumn = (rc.right() + x0) / cx;
+    const int firstRow = rc.top() / cy;
+    const int lastRow = qMin(rows - 1, rc.bottom() / cy);
+
+    const auto pixmapSimulated = _model->_iconPointGreen.pixmap(_iconSize);
+    const auto pixmapEmpty = _model->_iconPointEmpty.pixmap(_iconSize);
+
+    QPainter painter(viewport());
+    painter.setFont(font());
+    painter.setPen(palette().color(QPalette::Text));
+    auto& glyphs = GlyphCache::instance();
+    const int cells = cellCount();
+
+    for(int column = firstColumn; column <= lastColumn; column++)
+    {
+        for(int r = firstRow; r <= lastRow; r++)
+        {
+            const int row = column * rows + r;
+            if(row >= cells)
+                return;
+
+            const QRect cell(column * cx - x0, r * cy, cx, cy);
+            if(_bitsPerCell > 0)
+            {
+                paintBits(painter, cell, row * _bitsPerCell);
+                continue;
+            }
+
+            painter.drawPixmap(cell.left() + CellPadding, cell.top() + (cy - _iconSize) / 2,
+                               _model->_simulated.testBit(row) ? pixmapSimulated : pixmapEmpty);
+
+            auto rcText = cell.adjusted(_iconSize + 2 * CellPadding, 0, -_sparklineWidth, 0);
+            if(!_columnModes.isEmpty())
+                rcText.setWidth(_textWidth);
+
+            glyphs.drawText(painter, rcText, _model->cellText(row));
+
+            int x = rcText.right() + 1;
+            for(int c = 0; c < _columnWidths.size(); c++)
+            {
+                glyphs.drawText(painter, QRect(x, cell.top(), _columnWidths[c], cy), _model->columnText(row, c));
+                x += _columnWidths[c];
+            }
+
+            if(_showHistory && _model->historySeries(row, _series) > 1)
+            {
+                const auto minmax = std::minmax_element(_series.cbegin(), _series.cend());
+                const QRectF rcSparkline(cell.right() - CellPadding - _sparklineWidth, cell.top() + CellPadding,
+                                         _sparklineWidth, cy - 2 * CellPadding);
+
+                painter.save();
+                painter.setPen(QPen(palette().color(QPalette::Highlight), 1));
+                SparklineWidget::drawSparkline(painter, rcSparkline, _series.constData(), _series.size(), *minmax.first, *minmax.second);
+                painter.restore();
+            }
+        }
+    }
+}
+
+///
+/// \brief OutputDataView::paintBits
+/// Paints the address of the first bit and a square per bit, filled when the bit is set
+/// \param painter
+/// \param cell
+/// \param first the row of the first bit
+///
+void OutputDataView::paintBits(QPainter& painter, const QRect& cell, int first)
+{
+    const auto& dd = _model->_parentWidget->_displayDefinition;
+    const auto addrstr = formatAddress(dd.PointType, _model->address(first), _model->_parentWidget->displayHexAddresses());
+    const auto textColor = palette().color(QPalette::Text);
+
+    painter.setPen(textColor);
+    GlyphCache::instance().drawText(painter, QRect(cell.left() + CellPadding, cell.top(), _addressWidth, cell.height()),
+                                    addrstr + QLatin1Char(':'));
+
+    const QPen framePen(textColor, 1);
+    const QPen simulatedPen(Qt::darkGreen, 2);
+    const auto changedColor = palette().color(QPalette::Highlight);
+
+    const int count = qMin(_bitsPerCell, _rowCount - first);
+    for(int b = 0; b < count; b++)
+    {
+        const int row = first + b;
+        const auto rc = bitRect(cell, b);
+
+        if(_model->bitChanged(row))
+            painter.fillRect(rc.adjusted(-1, -1, 1, 1), changedColor);
+
+        if(_model->bit(row))
+            painter.fillRect(rc, textColor);
+
+        painter.setPen(_model->_simulated.testBit(row) ? simulatedPen : framePen);
+        painter.drawRect(rc.adjusted(0, 0, -1, -1));
+    }
+}
+
+///
+/// \brief OutputDataView::resizeEvent
+/// \param event
+///
+void OutputDataView::resizeEvent(QResizeEvent* event)
+{
+    QAbstractScrollArea::resizeEvent(event);
+
+    // the grid takes 32 bits per cell as soon as they fit
+    if(_bitsPerCell > 0 && _bitsPerCell != (viewport()->width() >= gridWidth(32) ? 32 : 16))
+        updateCellMetrics();
+    else
+        updateScrollBars();
+}
+
+///
+/// \brief OutputDataView::changeEvent
+/// \param event
+///
+void OutputDataView::changeEvent(QEvent* event)
+{
+    if(event->type() == QEvent::FontChange || event->type() == QEvent::StyleChange)
+        updateCellMetrics();
+
+    QAbstractScrollArea::changeEvent(event);
+}
+
+///
+/// \brief OutputDataView::wheelEvent
+/// The columns scroll sideways, so does the wheel
+/// \param event
+///
+void OutputDataView::wheelEvent(QWheelEvent* event)
+{
+    QCoreApplication::sendEvent(horizontalScrollBar(), event);
+}
+
+///
+/// \brief OutputDataView::mouseDoubleClickEvent
+/// \param event
+///
+void OutputDataView::mouseDoubleClickEvent(QMouseEvent* event)
+{
+    const auto index = indexAt(event->pos());
+    if(index.isValid())
+        emit doubleClicked(index);
+
+    QAbstractScrollArea::mouseDoubleClickEvent(event);
+}
+
+///
+/// \brief OutputDataView::viewportEvent
+/// Shows min, max and mean of the history of the cell under the mouse,
+/// in the bit grid the text of the bit comes first
+/// \param event
+/// \return
+///
+bool OutputDataView::viewportEvent(QEvent* event)
+{
+    if(event->type() == QEvent::ToolTip && (_showHistory || _bitsPerCell > 0))
+    {
+        const auto helpEvent = static_cast<QHelpEvent*>(event);
+        const int row = rowAt(helpEvent->pos());
+
+        QStringList lines;
+        if(_bitsPerCell > 0 && row >= 0)
+            lines.append(_model->cellText(row));
+
+        const auto stat = (_showHistory && row >= 0) ? _model->historyStatistics(row) : HistoryStatistics();
+        if(stat.Count > 0)
+        {
+            const QLocale locale;
+            lines.append(tr("Min: %1\nMax: %2\nMean: %3\n%4 samples over %5 s").arg(
+                         locale.toString(stat.Min, 'g', 16), locale.toString(stat.Max, 'g', 16),
+                         locale.toString(stat.Mean, 'g', 16), QString::number(stat.Count),
+                         locale.toString(stat.Span / 1000.0, 'f', 1)));
+        }
+
+        if(lines.isEmpty())
+        {
+            QToolTip::hideText();
+            event->ignore();
+            return true;
+        }
+
+        QToolTip::showText(helpEvent->globalPos(), lines.join(QLatin1Char('\n')), viewport(), rowRect(row));
+        return true;
+    }
+
+    return QAbstractScrollArea::viewportEvent(event);
+}
+
+///
+/// \brief OutputDataView::on_dataChanged
+/// Repaints the columns of the changed rows, relayouts if the form or the mode has changed
+/// \param topLeft
+/// \param bottomRight
+///
+void OutputDataView::on_dataChanged(const QModelIndex& topLeft, const QModelIndex& bottomRight)
+{
+    if(_model->rowCount() != _rowCount || _model->_parentWidget->dataDisplayMode() != _mode ||
+       _model->_history.isEnabled() != _showHistory || _model->isBitType() != (_bitsPerCell > 0))
+    {
+        updateCellMetrics();
+        return;
+    }
+
+    const int rows = rowsPerColumn();
+    const int firstCell = cellOf(topLeft.row());
+    const int lastCell = cellOf(bottomRight.row());
+    const int firstColumn = firstCell / rows;
+    const int lastColumn = lastCell / rows;
+    const int x0 = horizontalScrollBar()->value();
+
+    if(firstColumn == lastColumn)
+        viewport()->update(cellRect(firstCell).united(cellRect(lastCell)));
+    else
+        viewport()->update(firstColumn * _cellSize.width() - x0, 0, (lastColumn - firstColumn + 1) * _cellSize.width(), viewport()->height());
+}
+
+///
+/// \brief OutputDataView::updateCellMetrics
+/// All cells have the size of the longest text of the mode and the extra columns in the current font,
+/// grid cells the size of the bits that fit the width of the viewport
+///
+void OutputDataView::updateCellMetrics()
+{
+    _rowCount = _model ? qMax(0, _model->rowCount()) : 0;
+    _mode = _model ? _model->_parentWidget->dataDisplayMode() : DataDisplayMode::Binary;
+    _showHistory = _model && _model->_history.isEnabled();
+
+    // address, separator, value and room for the description
+    const int chars = 6 + 2 + valueChars(_mode) + 16;
+
+    const QFontMetrics fm(font());
+    const int charWidth = fm.horizontalAdvance(QLatin1Char('0'));
+    _bitSize = qMax(6, fm.ascent());
+    _groupGap = qMax(CellPadding, charWidth / 2);
+    _addressWidth = (6 + 2) * charWidth;
+
+    // every extra column has room for its longest value and a gap
+    int columnsWidth = 0;
+    _columnModes = _model ? _model->extraColumnModes() : QVector<DataDisplayMode>();
+    _columnWidths.resize(0);
+    for(auto&& m : std::as_const(_columnModes))
+    {
+        _columnWidths.append((valueChars(m) + 2) * charWidth);
+        columnsWidth += _columnWidths.last();
+    }
+
+    if(_model && _model->isBitType())
+    {
+        _bitsPerCell = viewport()->width() >= gridWidth(32) ? 32 : 16;
+        _sparklineWidth = 0;
+        _cellSize = QSize(gridWidth(_bitsPerCell), qMax(fm.height(), _bitSize) + 2 * CellPadding);
+
+        updateScrollBars();
+        viewport()->update();
+        return;
+    }
+
+    _bitsPerCell = 0;
+    _textWidth = chars * charWidth;
+    _sparklineWidth = _showHistory ? SparklineChars * charWidth : 0;
+    _iconSize = style()->pixelMetric(QStyle::PM_SmallIconSize, nullptr, this);
+    _cellSize = QSize(_iconSize + 3 * CellPadding + _textWidth + columnsWidth + (_showHistory ? _sparklineWidth + CellPadding : 0),
+                      qMax(fm.height(), _iconSize) + CellPadding);
+
+    updateScrollBars();
+    viewport()->update();
+}
+
+///
+/// \brief OutputDataView::updateScrollBars
+///
+void OutputDataView::updateScrollBars()
+{
+    const int rows = rowsPerColumn();
+    const int columns = (cellCount() + rows - 1) / rows;
+    const int width = viewport()->width();
+
+    auto bar = horizontalScrollBar();
+    bar->setRange(0, qMax(0, columns * _cellSize.width() - width));
+    bar->setPageStep(width);
+    bar->setSingleStep(qMax(1, _cellSize.width() / 3));
+}
+
+///
+/// \brief OutputDataView::rowsPerColumn
+/// \return
+///
+int OutputDataView::rowsPerColumn() const
+{
+    return qMax(1, viewport()->height() / _cellSize.height());
+}
+
+///
+/// \brief OutputDataView::cellCount
+/// \return number of cells, one per row or one per grid row of bits
+///
+int OutputDataView::cellCount() const
+{
+    return _bitsPerCell > 0 ? (_rowCount + _bitsPerCell - 1) / _bitsPerCell : _rowCount;
+}
+
+///
+/// \brief OutputDataView::cellOf
+/// \param row
+/// \return the cell that shows the row
+///
+int OutputDataView::cellOf(int row) const
+{
+    return _bitsPerCell > 0 ? row / _bitsPerCell : row;
+}
+
+///
+/// \brief OutputDataView::gridWidth
+/// \param bits
+/// \return the width of a grid cell of bits
+///
+int OutputDataView::gridWidth(int bits) const
+{
+    return 2 * CellPadding + _addressWidth + bits * (_bitSize + CellPadding) + (bits / GroupBits - 1) * _groupGap;
+}
+
+///
+/// \brief OutputDataView::bitAt
+/// \param x position inside a grid cell
+/// \return the bit at the position, -1 if there is none
+///
+int OutputDataView::bitAt(int x) const
+{
+    const int step = _bitSize + CellPadding;
+    const int groupWidth = GroupBits * step + _groupGap;
+
+    x -= CellPadding + _addressWidth;
+    if(x < 0)
+        return -1;
+
+    const int bit = x / groupWidth * GroupBits + x % groupWidth / step;
+    return (x % groupWidth < GroupBits * step && bit < _bitsPerCell) ? bit : -1;
+}
+
+///
+/// \brief OutputDataView::cellRect
+/// \param cell
+/// \return the cell in viewport coordinates
+///
+QRect OutputDataView::cellRect(int cell) const
+{
+    const int rows = rowsPerColumn();
+    return QRect(cell / rows * _cellSize.width() - horizontalScrollBar()->value(),
+                 cell % rows * _cellSize.height(), _cellSize.width(), _cellSize.height());
+}
+
+///
+/// \brief OutputDataView::bitRect
+/// \param cell
+/// \param bit
+/// \return the square of a bit inside a grid cell
+///
+QRect OutputDataView::bitRect(const QRect& cell, int bit) const
+{
+    const int x = CellPadding + _addressWidth + bit * (_bitSize + CellPadding) + bit / GroupBits * _groupGap;
+    return QRect(cell.left() + x, cell.top() + (cell.height() - _bitSize) / 2, _bitSize, _bitSize);
+}
+
+///
+/// \brief OutputDataView::rowRect
+/// \param row
+/// \return the area that shows the row in viewport coordinates
+///
+QRect OutputDataView::rowRect(int row) const
+{
+    const auto cell = cellRect(cellOf(row));
+    return _bitsPerCell > 0 ? bitRect(cell, row % _bitsPerCell) : cell;
+}
@@ -0,0 +1,81 @@
+#ifndef OUTPUTDATAVIEW_H
+#define OUTPUTDATAVIEW_H
+
+#include <QAbstractScrollArea>
+#include <QVector>
+#include <QModelIndex>
+#include "enums.h"
+
+class OutputListModel;
+
+///
+/// \brief The OutputDataView class
+/// Shows the points of an OutputListModel in columns of cells that all have the
+/// same size. Only the cells inside the viewport are painted and they are
+/// formatted from the data words on every paint, so nothing is kept per point.
+/// Extra columns of other display modes follow the text of the cell and
+/// when the form keeps a history every cell also gets a sparkline of it.
+/// Coils and discrete inputs are shown as a grid of 16 or 32 bits per cell
+/// with the bits changed by the last update highlighted.
+///
+class OutputDataView : public QAbstractScrollArea
+{
+    Q_OBJECT
+
+public:
+    explicit OutputDataView(QWidget* parent = nullptr);
+
+    OutputListModel* model() const {
+        return _model;
+    }
+    void setModel(OutputListModel* model);
+
+    int rowAt(const QPoint& pos) const;
+    QModelIndex indexAt(const QPoint& pos) const;
+
+signals:
+    void doubleClicked(const QModelIndex& index);
+
+protected:
+    void paintEvent(QPaintEvent* event) override;
+    void resizeEvent(QResizeEvent* event) override;
+    void changeEvent(QEvent* event) override;
+    void wheelEvent(QWheelEvent* event) override;
+    void mouseDoubleClickEvent(QMouseEvent* event) override;
+    bool viewportEvent(QEvent* event) override;
+
+private slots:
+    void on_dataChanged(const QModelIndex& topLeft, const QModelIndex& bottomRight);
+
+private:
+    void updateCellMetrics();
+    void updateScrollBars();
+    int rowsPerColumn() const;
+    int cellCount() const;
+    int cellOf(int row) const;
+    int gridWidth(int bits) const;
+    int bitAt(int x) const;
+    QRect cellRect(int cell) const;
+    QRect bitRect(const QRect& cell, int bit) const;
+    QRect rowRect(int row) const;
+    void paintBits(QPainter& painter, const QRect& cell, int first);
+
+private:
+    OutputListModel* _model;
+    DataDisplayMode _mode;
+    int _rowCount;
+    int _iconSize;
+    QSize _cellSize;
+    int _textWidth;
+    QVector<DataDisplayMode> _columnModes;
+    QVector<int> _columnWidths;
+    bool _showHistory;
+    int _sparklineWidth;
+    QVector<double> _series;
+    int _bitsPerCell;
+    int _bitSize;
+    int _groupGap;
+    int _addressWidth;
+};
+
+#endif // OUTPUTDATAVIEW_H
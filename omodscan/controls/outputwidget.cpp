@@ -1,10 +1,13 @@
+#include <utility>
 #include <QDateTime>
 #include <QPainter>
+#include <QtAlgorithms>
 #include <QTextStream>
 #include <QInputDialog>
 #include "formatutils.h"
 #include "outputwidget.h"
 #include "modbusmessages.h"
+#include "requesttracer.h"
 #include "ui_outputwidget.h"
 
 ///
@@ -14,6 +17,8 @@ const int SimulationRole = Qt::UserRole + 1;
 
 ///
 /// \brief CaptureRole
+/// The value of a row and its extra columns without markup. Text capture
+/// writes the traffic log only and does not ask for it.
 ///
 const int CaptureRole = Qt::UserRole + 2;
 
@@ -67,53 +72,263 @@ int OutputListModel::rowCount(const QModelIndex&) const
 ///
 QVariant OutputListModel::data(const QModelIndex& index, int role) const
 {
-    if(!index.isValid() ||
-       !_mapItems.contains(index.row()))
+    const auto row = index.row();
+    if(!index.isValid() || row >= _cache.size())
     {
         return QVariant();
     }
 
-    const auto row = index.row();
-    const auto pointType = _parentWidget->_displayDefinition.PointType;
-    const auto hexAddresses = _parentWidget->displayHexAddresses();
-
-    const ItemData& itemData = _mapItems[row];
-    const auto addrstr = formatAddress(pointType, itemData.Address, hexAddresses);
-
     switch(role)
     {
         case Qt::DisplayRole:
-        {
-            auto str = QString("%1: %2").arg(addrstr, itemData.ValueStr);
-            const int length = str.length();
-            const auto descr = itemData.Description.length() > 20 ?
-                        QString("%1...").arg(itemData.Description.left(18)): itemData.Description;
-            if(!descr.isEmpty()) str += QString("; %1").arg(descr);
-            return str.leftJustified(length + 16, ' ');
-        }
+            formatRow(row);
+            return _displayStrs[row];
 
         case CaptureRole:
-            return QString(itemData.ValueStr).remove('<').remove('>');
+            formatRow(row);
+            return QString(_valueStrs[row]).remove('<').remove('>');
 
         case AddressStringRole:
-            return addrstr;
+            return formatAddress(_parentWidget->_displayDefinition.PointType, address(row), _parentWidget->displayHexAddresses());
 
         case AddressRole:
-            return itemData.Address;
+            return address(row);
 
         case ValueRole:
-            return itemData.Value;
+            formatRow(row);
+            return _values[row];
 
         case DescriptionRole:
-            return itemData.Description;
+            return description(row);
 
         case Qt::DecorationRole:
-            return itemData.Simulated ? _iconPointGreen : _iconPointEmpty;
+            return _simulated.testBit(row) ? _iconPointGreen : _iconPointEmpty;
     }
 
     return QVariant();
 }
 
+///
+/// \brief composeText
+/// \param addrstr
+/// \param valueStr
+/// \param desc
+/// \param length receives the length of the text without the description
+/// \return the text of a point as the data view shows it
+///
+static QString composeText(const QString& addrstr, const QString& valueStr, const QString& desc, int& length)
+{
+    auto str = QString("%1: %2").arg(addrstr, valueStr);
+    length = str.length();
+    const auto descr = desc.length() > 20 ? QString("%1...").arg(desc.left(18)): desc;
+    if(!descr.isEmpty()) str += QString("; %1").arg(descr);
+    return str;
+}
+
+///
+/// \brief OutputListModel::ensureDecoded
+/// Decodes the data for the current mode, byte order and extra columns
+/// and picks the pipelines that format them
+///
+void OutputListModel::ensureDecoded() const
+{
+    const auto pointType = _parentWidget->_displayDefinition.PointType;
+    const auto mode = _parentWidget->dataDisplayMode();
+    const auto byteOrder = _parentWidget->byteOrder();
+    if(!_decoded.isDecoded(mode, byteOrder))
+    {
+        // bits are formatted straight from the packed words, there is nothing to decode
+        if(isBitType()) _decoded.decode(QModbusDataUnit(), 0, mode, byteOrder);
+        else _decoded.decode(_lastData, rowCount(), mode, byteOrder);
+
+        _pipeline = formatPipeline(pointType, mode, byteOrder);
+        _bitPipeline = bitPipeline(mode, byteOrder);
+        _columnsDecoded = false;
+    }
+
+    if(_columnsDecoded)
+        return;
+
+    // a column only gets its own decode pass if no other column has the layout
+    int decoded = 0;
+    _columns.resize(0);
+    for(auto&& m : extraColumnModes())
+    {
+        ColumnFormat column;
+        column.Mode = m;
+        column.Pipeline = formatPipeline(pointType, m, byteOrder);
+
+        if(!_decoded.isDecodedAs(m, byteOrder))
+        {
+            for(int k = 0; k < decoded && column.Decoded < 0; k++)
+            {
+                if(_columnDecoded[k].isDecodedAs(m, byteOrder))
+                    column.Decoded = k;
+            }
+
+            if(column.Decoded < 0)
+            {
+                if(_columnDecoded.size() <= decoded)
+                    _columnDecoded.resize(decoded + 1);
+
+                _columnDecoded[decoded].decode(_lastData, rowCount(), m, byteOrder);
+                column.Decoded = decoded++;
+            }
+        }
+
+        _columns.append(column);
+    }
+
+    _columnDecoded.resize(decoded);
+    _columnsDecoded = true;
+}
+
+///
+/// \brief OutputListModel::clearDecoded
+/// Drops the decoded values of all columns, e.g. when the data has changed
+///
+void OutputListModel::clearDecoded()
+{
+    _decoded.clear();
+    _columnsDecoded = false;
+}
+
+///
+/// \brief OutputListModel::resetColumns
+/// Makes the rows format the extra columns again
+///
+void OutputListModel::resetColumns()
+{
+    _columnsDecoded = false;
+    for(auto&& cache : _cache)
+        cache.Valid = false;
+
+    emit columnsReset();
+}
+
+///
+/// \brief OutputListModel::extraColumnModes
+/// Known from the settings alone, nothing gets decoded
+/// \return the modes of the columns shown next to the value of the display mode
+///
+QVector<DataDisplayMode> OutputListModel::extraColumnModes() const
+{
+    QVector<DataDisplayMode> modes;
+    if(isBitType())
+        return modes;
+
+    const auto mode = _parentWidget->dataDisplayMode();
+    for(auto&& m : std::as_const(_parentWidget->_extraColumns))
+    {
+        if(m != mode) modes.append(m);
+    }
+
+    return modes;
+}
+
+///
+/// \brief OutputListModel::columnText
+/// \param row
+/// \param column
+/// \return the value of an extra column, empty if no value of the column starts at the row
+///
+QString OutputListModel::columnText(int row, int column) const
+{
+    ensureDecoded();
+
+    QVariant value;
+    const auto& c = _columns[column];
+    return c.Pipeline(_lastData, c.Decoded < 0 ? _decoded : _columnDecoded[c.Decoded], row, rowCount(), value);
+}
+
+///
+/// \brief OutputListModel::valueStep
+/// \return the number of words the widest value of all columns is made of
+///
+int OutputListModel::valueStep() const
+{
+    int step = registersPerValue(_parentWidget->dataDisplayMode());
+    if(!isBitType())
+    {
+        for(auto&& m : std::as_const(_parentWidget->_extraColumns))
+            step = qMax(step, registersPerValue(m));
+    }
+
+    return step;
+}
+
+///
+/// \brief OutputListModel::cellText
+/// Formats a row from the words without touching the row cache
+/// \param row
+/// \return
+///
+QString OutputListModel::cellText(int row) const
+{
+    ensureDecoded();
+
+    QVariant value;
+    const auto valueStr = pointText(row, value);
+    const auto addrstr = formatAddress(_parentWidget->_displayDefinition.PointType, address(row), _parentWidget->displayHexAddresses());
+
+    int length = 0;
+    return composeText(addrstr, valueStr, description(row), length);
+}
+
+///
+/// \brief OutputListModel::pointText
+/// \param row
+/// \param value receives the value of the point
+/// \return the value of the row in the display mode, bits are formatted from the packed words
+///
+QString OutputListModel::pointText(int row, QVariant& value) const
+{
+    if(isBitType())
+        return _bitPipeline(_bits, row, value);
+
+    return _pipeline(_lastData, _decoded, row, rowCount(), value);
+}
+
+///
+/// \brief OutputListModel::formatRow
+/// Formats a row when it is asked for. The strings are cached until
+/// the words of the value, the display mode, the byte order or the
+/// address format change.
+/// \param row
+///
+void OutputListModel::formatRow(int row) const
+{
+    const auto mode = _parentWidget->dataDisplayMode();
+    const auto byteOrder = _parentWidget->byteOrder();
+    const auto hexAddresses = _parentWidget->displayHexAddresses();
+    const auto words = valueWords(row, valueStep());
+
+    auto& cache = _cache[row];
+    if(cache.Valid && cache.Words == words && cache.Mode == mode &&
+       cache.Order == byteOrder && cache.HexAddresses == hexAddresses)
+    {
+        return;
+    }
+
+    ensureDecoded();
+
+    auto& valueStr = _valueStrs[row];
+    valueStr = pointText(row, _values[row]);
+    for(int c = 0; c < _columns.size(); c++)
+        valueStr += QLatin1String(" | ") + columnText(row, c);
+
+    const auto addrstr = formatAddress(_parentWidget->_displayDefinition.PointType, address(row), hexAddresses);
+    int length = 0;
+    const auto str = composeText(addrstr, valueStr, description(row), length);
+    _displayStrs[row] = str.leftJustified(length + 16, ' ');
+
+    cache.Words = words;
+    cache.Mode = mode;
+    cache.Order = byteOrder;
+    cache.HexAddresses = hexAddresses;
+    cache.Valid = true;
+}
+
 ///
 /// \brief OutputListModel::setData
 /// \param index
@@ -123,8 +338,8 @@ QVariant OutputListModel::data(const QModelIndex& index, int role) const
 ///
 bool OutputListModel::setData(const QModelIndex &index, const QVariant &value, int role)
 {
-    if(!index.isValid() ||
-       !_mapItems.contains(index.row()))
+    const auto row = index.row();
+    if(!index.isValid() || row >= _cache.size())
     {
         return false;
     }
@@ -132,14 +347,24 @@ bool OutputListModel::setData(const QModelIndex &index, const QVariant &value, i
     switch (role)
     {
         case SimulationRole:
-            _mapItems[index.row()].Simulated = value.toBool();
+            _simulated.setBit(row, value.toBool());
             emit dataChanged(index, index, QVector<int>() << role);
         return true;
 
 
         case DescriptionRole:
-            _mapItems[index.row()].Description = value.toString();
+        {
+            const auto desc = value.toString();
+            int id = desc.isEmpty() ? -1 : _descriptions.indexOf(desc);
+            if(id < 0 && !desc.isEmpty())
+            {
+                id = _descriptions.size();
+                _descriptions.append(desc);
+            }
+            _descriptionIds[row] = id;
+            _cache[row].Valid = false;
             emit dataChanged(index, index, QVector<int>() << role);
+        }
         return true;
 
         default:
@@ -156,13 +381,47 @@ bool OutputListModel::isValid() const
     return _lastData.isValid();
 }
 
+///
+/// \brief OutputListModel::memoryUsage
+/// \return approximate number of bytes held by the rows
+///
+qint64 OutputListModel::memoryUsage() const
+{
+    qint64 size = sizeof(OutputListModel) + _lastData.values().size() * sizeof(quint16);
+    size += _simulated.size() / 8;
+    size += _descriptionIds.capacity() * sizeof(int);
+    size += _values.capacity() * sizeof(QVariant);
+    size += (_valueStrs.capacity() + _displayStrs.capacity()) * sizeof(QString);
+    size += _cache.capacity() * sizeof(ValueCache);
+    size += _decoded.memoryUsage();
+    for(auto&& decoded : _columnDecoded)
+        size += decoded.memoryUsage();
+    size += _history.memoryUsage();
+    size += _bits.memoryUsage() + _changedBits.memoryUsage();
+
+    for(int i = 0; i < _valueStrs.size(); i++)
+        size += (_valueStrs[i].capacity() + _displayStrs[i].capacity()) * sizeof(QChar);
+
+    for(auto&& desc : _descriptions)
+        size += sizeof(QString) + desc.capacity() * sizeof(QChar);
+
+    return size;
+}
+
 ///
 /// \brief OutputListModel::values
 /// \return
 ///
 QVector<quint16> OutputListModel::values() const
 {
-    return _lastData.values();
+    if(!isBitType())
+        return _lastData.values();
+
+    QVector<quint16> values(_lastData.valueCount());
+    for(int i = 0; i < values.size(); i++)
+        values[i] = bit(i);
+
+    return values;
 }
 
 ///
@@ -170,120 +429,279 @@ QVector<quint16> OutputListModel::values() const
 ///
 void OutputListModel::clear()
 {
-    _mapItems.clear();
+    _simulated.clear();
+    _descriptionIds.clear();
+    _descriptions.clear();
+    _values.clear();
+    _valueStrs.clear();
+    _displayStrs.clear();
+    _cache.clear();
+
     updateData(QModbusDataUnit());
+    resetHistory();
 }
 
 ///
 /// \brief OutputListModel::update
+/// Makes the view ask for every row again, e.g. after the display mode has changed
 ///
 void OutputListModel::update()
 {
-    updateData(_lastData);
+    if(rowCount() <= 0)
+        return;
+
+    emit dataChanged(index(0), index(rowCount() - 1), QVector<int>() << Qt::DisplayRole);
+}
+
+///
+/// \brief OutputListModel::resizeRows
+/// Sizes the row arrays for the current definition and drops the cached strings
+///
+void OutputListModel::resizeRows()
+{
+    const int count = qMax(0, rowCount());
+    const int oldCount = _descriptionIds.size();
+
+    _simulated.resize(count);
+    _descriptionIds.resize(count);
+    for(int i = oldCount; i < count; i++)
+        _descriptionIds[i] = -1;
+
+    _values.resize(count);
+    _valueStrs.resize(count);
+    _displayStrs.resize(count);
+    _cache.fill(ValueCache(), count);
+}
+
+///
+/// \brief OutputListModel::resetHistory
+/// Sizes the history for the current definition, the samples are dropped
+///
+void OutputListModel::resetHistory()
+{
+    _history.setup(_parentWidget->_displayDefinition.HistoryDepth, qMax(0, rowCount()));
+}
+
+///
+/// \brief OutputListModel::appendHistory
+/// \param data
+///
+void OutputListModel::appendHistory(const QModbusDataUnit& data)
+{
+    _history.append(data, QDateTime::currentMSecsSinceEpoch());
+}
+
+///
+/// \brief historyMode
+/// Coils and discrete inputs keep their single words whatever the display mode is
+/// \param pointType
+/// \param mode
+/// \return
+///
+static DataDisplayMode historyMode(QModbusDataUnit::RegisterType pointType, DataDisplayMode mode)
+{
+    switch(pointType)
+    {
+        case QModbusDataUnit::Coils:
+        case QModbusDataUnit::DiscreteInputs:
+            return DataDisplayMode::UInt16;
+
+        default:
+            return mode;
+    }
+}
+
+///
+/// \brief OutputListModel::historySeries
+/// \param row
+/// \param values receives the values of the row, oldest first
+/// \return number of values
+///
+int OutputListModel::historySeries(int row, QVector<double>& values) const
+{
+    const auto mode = historyMode(_parentWidget->_displayDefinition.PointType, _parentWidget->dataDisplayMode());
+    return _history.series(row, mode, _parentWidget->byteOrder(), values);
+}
+
+///
+/// \brief OutputListModel::historyStatistics
+/// \param row
+/// \return
+///
+HistoryStatistics OutputListModel::historyStatistics(int row) const
+{
+    const auto mode = historyMode(_parentWidget->_displayDefinition.PointType, _parentWidget->dataDisplayMode());
+    return _history.statistics(row, mode, _parentWidget->byteOrder());
+}
+
+///
+/// \brief dataHeader
+/// \param data
+/// \return the data unit without its values, the value count is kept
+///
+static QModbusDataUnit dataHeader(const QModbusDataUnit& data)
+{
+    QModbusDataUnit header(data.registerType(), data.startAddress(), QVector<quint16>());
+    header.setValueCount(data.valueCount());
+    return header;
 }
 
 ///
 /// \brief OutputListModel::updateData
+/// Compares the words with the last data and signals the rows of the
+/// changed values as contiguous ranges, the view then asks for them again
 /// \param data
+/// \return true if any row has changed
 ///
-void OutputListModel::updateData(const QModbusDataUnit& data)
+bool OutputListModel::updateData(const QModbusDataUnit& data)
 {
-    _lastData = data;
+    const bool full = _cache.size() != rowCount() ||
+                      !data.isValid() || !_lastData.isValid() ||
+                      data.registerType() != _lastData.registerType() ||
+                      data.startAddress() != _lastData.startAddress() ||
+                      data.valueCount() != _lastData.valueCount();
 
-    const auto mode = _parentWidget->dataDisplayMode();
-    const auto pointType = _parentWidget->_displayDefinition.PointType;
-    const auto byteOrder = _parentWidget->byteOrder();
+    const auto lastData = _lastData;
+    _lastData = isBitType() ? dataHeader(data) : data;
 
-    for(int i = 0; i < rowCount(); i++)
+    if(full)
     {
-        const auto value = _lastData.value(i);
+        clearDecoded();
+        resizeRows();
 
-        auto& itemData = _mapItems[i];
-        itemData.Address = _parentWidget->_displayDefinition.PointAddress + i;
+        if(isBitType()) _bits.assign(data, rowCount());
+        else _bits.clear();
+        _changedBits.resize(_bits.size());
 
-        switch(mode)
-        {
-            case DataDisplayMode::Binary:
-                itemData.ValueStr = formatBinaryValue(pointType, value, byteOrder, itemData.Value);
-            break;
-
-            case DataDisplayMode::UInt16:
-                itemData.ValueStr = formatUInt16Value(pointType, value, byteOrder, itemData.Value);
-            break;
-
-            case DataDisplayMode::Int16:
-                itemData.ValueStr = formatInt16Value(pointType, value, byteOrder, itemData.Value);
-            break;
-
-            case DataDisplayMode::Hex:
-                itemData.ValueStr = formatHexValue(pointType, value, byteOrder, itemData.Value);
-            break;
-
-            case DataDisplayMode::FloatingPt:
-                itemData.ValueStr = formatFloatValue(pointType, value, _lastData.value(i+1), byteOrder,
-                                          (i%2) || (i+1>=rowCount()), itemData.Value);
-            break;
-
-            case DataDisplayMode::SwappedFP:
-                itemData.ValueStr = formatFloatValue(pointType, _lastData.value(i+1), value, byteOrder,
-                                          (i%2) || (i+1>=rowCount()), itemData.Value);
-            break;
-
-            case DataDisplayMode::DblFloat:
-                itemData.ValueStr = formatDoubleValue(pointType, value, _lastData.value(i+1), _lastData.value(i+2), _lastData.value(i+3),
-                                           byteOrder, (i%4) || (i+3>=rowCount()), itemData.Value);
-            break;
-
-            case DataDisplayMode::SwappedDbl:
-                itemData.ValueStr = formatDoubleValue(pointType, _lastData.value(i+3), _lastData.value(i+2), _lastData.value(i+1), value,
-                                           byteOrder, (i%4) || (i+3>=rowCount()), itemData.Value);
-            break;
-
-            case DataDisplayMode::Int32:
-                itemData.ValueStr = formatInt32Value(pointType, value, _lastData.value(i+1), byteOrder,
-                                              (i%2) || (i+1>=rowCount()), itemData.Value);
-            break;
-
-            case DataDisplayMode::SwappedInt32:
-                itemData.ValueStr = formatInt32Value(pointType, _lastData.value(i+1), value, byteOrder,
-                                              (i%2) || (i+1>=rowCount()), itemData.Value);
-
-            break;
-
-            case DataDisplayMode::UInt32:
-                itemData.ValueStr = formatUInt32Value(pointType, value, _lastData.value(i+1), byteOrder,
-                                              (i%2) || (i+1>=rowCount()), itemData.Value);
-            break;
-
-            case DataDisplayMode::SwappedUInt32:
-                itemData.ValueStr = formatUInt32Value(pointType, _lastData.value(i+1), value, byteOrder,
-                                              (i%2) || (i+1>=rowCount()), itemData.Value);
-            break;
-
-            case DataDisplayMode::Int64:
-                itemData.ValueStr = formatInt64Value(pointType, value, _lastData.value(i+1), _lastData.value(i+2), _lastData.value(i+3),
-                                           byteOrder, (i%4) || (i+3>=rowCount()), itemData.Value);
-                break;
+        update();
+        return rowCount() > 0;
+    }
 
-            case DataDisplayMode::SwappedInt64:
-                itemData.ValueStr = formatInt64Value(pointType, _lastData.value(i+3), _lastData.value(i+2), _lastData.value(i+1), value,
-                                                     byteOrder, (i%4) || (i+3>=rowCount()), itemData.Value);
+    if(isBitType())
+        return updateBits(data);
 
-                break;
+    const auto step = valueStep();
+    const auto count = rowCount();
 
-            case DataDisplayMode::UInt64:
-                itemData.ValueStr = formatUInt64Value(pointType, value, _lastData.value(i+1), _lastData.value(i+2), _lastData.value(i+3),
-                                           byteOrder, (i%4) || (i+3>=rowCount()), itemData.Value);
-                break;
+    int first = -1;
+    bool updated = false;
+    for(int i = 0; i < count; i += step)
+    {
+        const int last = qMin(i + step, count) - 1;
 
-            case DataDisplayMode::SwappedUInt64:
-                itemData.ValueStr = formatUInt64Value(pointType, _lastData.value(i+3), _lastData.value(i+2), _lastData.value(i+1), value,
-                                                      byteOrder, (i%4) || (i+3>=rowCount()), itemData.Value);
-                break;
+        bool changed = false;
+        for(int k = i; k <= last && !changed; k++)
+            changed = data.value(k) != lastData.value(k);
+
+        if(changed)
+        {
+            if(first < 0) first = i;
+            updated = true;
+        }
+        else if(first >= 0)
+        {
+            emit dataChanged(index(first), index(i - 1), QVector<int>() << Qt::DisplayRole);
+            first = -1;
         }
     }
 
-    emit dataChanged(index(0), index(rowCount() - 1), QVector<int>() << Qt::DisplayRole);
+    if(updated)
+        clearDecoded();
+
+    if(first >= 0)
+        emit dataChanged(index(first), index(count - 1), QVector<int>() << Qt::DisplayRole);
+
+    return updated;
+}
+
+///
+/// \brief OutputListModel::updateBits
+/// Packs the coils or discrete inputs and compares them with the last ones
+/// 64 at a time. The rows of every run of changed words are signalled as one range,
+/// together with the rows changed by the last update so their highlight goes away.
+/// \param data
+/// \return true if any bit has changed
+///
+bool OutputListModel::updateBits(const QModbusDataUnit& data)
+{
+    PackedBits bits;
+    bits.assign(data, rowCount());
+
+    PackedBits changed;
+    const bool updated = bits.diff(_bits, changed);
+    std::swap(_bits, bits);
+
+    if(updated)
+        clearDecoded();
+
+    // the rows to repaint are the ones changed now or by the last update
+    std::swap(_changedBits, changed);
+    PackedBits& repaint = changed;
+    if(repaint.size() == _changedBits.size()) repaint.unite(_changedBits);
+    else repaint = _changedBits;
+
+    const int words = repaint.wordCount();
+    for(int w = 0; w < words; w++)
+    {
+        if(repaint.word(w) == 0)
+            continue;
+
+        int last = w;
+        while(last + 1 < words && repaint.word(last + 1) != 0)
+            last++;
+
+        const int first = repaint.nextSetBit(w * 64);
+        const int end = 63 - int(qCountLeadingZeroBits(repaint.word(last)));
+        emit dataChanged(index(first), index(last * 64 + end), QVector<int>() << Qt::DisplayRole);
+
+        w = last;
+    }
+
+    return updated;
+}
+
+///
+/// \brief OutputListModel::isBitType
+/// \return true for coils and discrete inputs
+///
+bool OutputListModel::isBitType() const
+{
+    switch(_parentWidget->_displayDefinition.PointType)
+    {
+        case QModbusDataUnit::Coils:
+        case QModbusDataUnit::DiscreteInputs:
+            return true;
+
+        default:
+            return false;
+    }
+}
+
+///
+/// \brief OutputListModel::address
+/// \param row
+/// \return
+///
+quint32 OutputListModel::address(int row) const
+{
+    return _parentWidget->_displayDefinition.PointAddress + row;
+}
+
+///
+/// \brief OutputListModel::valueWords
+/// \param row
+/// \param step number of words, 4 at most
+/// \return the words a row is formatted from, packed
+///
+quint64 OutputListModel::valueWords(int row, int step) const
+{
+    const bool bits = isBitType();
+
+    quint64 words = 0;
+    for(int k = 0; k < step; k++)
+        words |= quint64(bits ? bit(row + k) : _lastData.value(row + k)) << (16 * k);
+
+    return words;
 }
 
 ///
@@ -320,7 +738,8 @@ OutputWidget::OutputWidget(QWidget *parent) :
 {
     ui->setupUi(this);
     ui->stackedWidget->setCurrentIndex(0);
-    ui->listView->setModel(_listModel.get());
+    ui->dataView->setModel(_listModel.get());
+    ui->dataView->viewport()->installEventFilter(this);
     ui->labelStatus->setAutoFillBackground(true);
 
     setAutoFillBackground(true);
@@ -336,6 +755,18 @@ OutputWidget::OutputWidget(QWidget *parent) :
                 if(!sel.indexes().isEmpty())
                     showModbusMessage(sel.indexes().first());
             });
+
+    // the log drops its oldest messages when the memory budget is hit
+    connect(ui->logView->model(),
+            &QAbstractItemModel::rowsAboutToBeRemoved,
+            this, [&](const QModelIndex&, int first, int last) {
+                const auto msg = ui->modbusMsg->modbusMessage();
+                for(int row = first; row <= last && msg != nullptr; row++)
+                {
+                    if(ui->logView->cachedItemAt(ui->logView->index(row)) == msg)
+                        ui->modbusMsg->setModbusMessage(nullptr);
+                }
+            });
 }
 
 ///
@@ -361,6 +792,30 @@ void OutputWidget::changeEvent(QEvent* event)
     QWidget::changeEvent(event);
 }
 
+///
+/// \brief OutputWidget::eventFilter
+/// \param obj
+/// \param event
+/// \return
+///
+bool OutputWidget::eventFilter(QObject* obj, QEvent* event)
+{
+    if(event->type() == QEvent::Paint &&
+       obj == ui->dataView->viewport() &&
+       RequestTracer::instance().isEnabled())
+    {
+        // deliver the paint event first so that dataPainted() follows the actual painting
+        obj->removeEventFilter(this);
+        QCoreApplication::sendEvent(obj, event);
+        obj->installEventFilter(this);
+
+        emit dataPainted();
+        return true;
+    }
+
+    return QWidget::eventFilter(obj, event);
+}
+
 ///
 /// \brief OutputWidget::data
 /// \return
@@ -449,7 +904,7 @@ void OutputWidget::stopTextCapture()
 ///
 QColor OutputWidget::backgroundColor() const
 {
-    return ui->listView->palette().color(QPalette::Base);
+    return ui->dataView->palette().color(QPalette::Base);
 }
 
 ///
@@ -470,7 +925,7 @@ void OutputWidget::setBackgroundColor(const QColor& clr)
 ///
 QColor OutputWidget::foregroundColor() const
 {
-    return ui->listView->palette().color(QPalette::Text);
+    return ui->dataView->palette().color(QPalette::Text);
 }
 
 ///
@@ -479,9 +934,9 @@ QColor OutputWidget::foregroundColor() const
 ///
 void OutputWidget::setForegroundColor(const QColor& clr)
 {
-    auto pal = ui->listView->palette();
+    auto pal = ui->dataView->palette();
     pal.setColor(QPalette::Text, clr);
-    ui->listView->setPalette(pal);
+    ui->dataView->setPalette(pal);
 }
 
 ///
@@ -511,7 +966,7 @@ void OutputWidget::setStatusColor(const QColor& clr)
 ///
 QFont OutputWidget::font() const
 {
-    return ui->listView->font();
+    return ui->dataView->font();
 }
 
 ///
@@ -520,7 +975,7 @@ QFont OutputWidget::font() const
 ///
 void OutputWidget::setFont(const QFont& font)
 {
-    ui->listView->setFont(font);
+    ui->dataView->setFont(font);
     ui->labelStatus->setFont(font);
     ui->logView->setFont(font);
     ui->modbusMsg->setFont(font);
@@ -549,6 +1004,7 @@ void OutputWidget::setLogViewLimit(int l)
 ///
 void OutputWidget::clearLogView()
 {
+    ui->modbusMsg->setModbusMessage(nullptr);
     ui->logView->clear();
 }
 
@@ -570,48 +1026,101 @@ void OutputWidget::setStatus(const QString& status)
     }
 }
 
+///
+/// \brief trimmedLength
+/// \param s
+/// \return the length of a string without its trailing spaces
+///
+static int trimmedLength(const QString& s)
+{
+    int length = s.length();
+    while(length > 0 && s.at(length - 1).isSpace())
+        length--;
+
+    return length;
+}
+
+///
+/// \brief OutputWidget::printCellWidth
+/// Every page gets the same grid, so the longest text of all rows sets the width.
+/// Meant to be measured once per print job and passed to every paint call.
+/// \param fm metrics of the font the rows are printed with
+/// \return the width of a printed cell
+///
+int OutputWidget::printCellWidth(const QFontMetrics& fm) const
+{
+    QString longest;
+    int longestLength = 0;
+    for(int i = 0; i < _listModel->rowCount(); i++)
+    {
+        const auto s = _listModel->data(_listModel->index(i), Qt::DisplayRole).toString();
+        const int length = trimmedLength(s);
+        if(length > longestLength)
+        {
+            longest = s;
+            longestLength = length;
+        }
+    }
+    longest.truncate(longestLength);
+
+    return qMax(fm.horizontalAdvance(longest), fm.horizontalAdvance(QString(longestLength, QLatin1Char('0'))));
+}
+
 ///
 /// \brief OutputWidget::paint
+/// Lays the rows out in columns of the same width, so the grid is known without
+/// measuring every row. The rows that do not fit are left for the next page.
 /// \param rc
 /// \param painter
+/// \param row the first row to paint, moves past the painted rows
+/// \param cellWidth width of a cell from printCellWidth
+/// \return true if there are rows left to paint
 ///
-void OutputWidget::paint(const QRect& rc, QPainter& painter)
+bool OutputWidget::paint(const QRect& rc, QPainter& painter, int& row, int cellWidth)
 {
-    const auto textStatus = ui->labelStatus->text();
-    auto rcStatus = painter.boundingRect(rc.left(), rc.top(), rc.width(), rc.height(), Qt::TextWordWrap, textStatus);
-    painter.drawText(rcStatus, Qt::TextWordWrap, textStatus);
-
-    rcStatus.setBottom(rcStatus.bottom() + 4);
-    painter.drawLine(rc.left(), rcStatus.bottom(), rc.right(), rcStatus.bottom());
-    rcStatus.setBottom(rcStatus.bottom() + 4);
+    const int count = _listModel->rowCount();
+    if(row >= count)
+        return false;
 
-    int cx = rc.left();
-    int cy = rcStatus.bottom();
-    int maxWidth = 0;
-    for(int i = 0; i < _listModel->rowCount(); ++i)
+    int top = rc.top();
+    if(row <= 0)
     {
-        const auto text = _listModel->data(_listModel->index(i), Qt::DisplayRole).toString().trimmed();
-        auto rcItem = painter.boundingRect(cx, cy, rc.width() - cx, rc.height() - cy, Qt::TextSingleLine, text);
-        maxWidth = qMax(maxWidth, rcItem.width());
+        row = 0;
 
-        if(rcItem.right() > rc.right()) break;
-        else if(rcItem.bottom() < rc.bottom())
-        {
-            painter.drawText(rcItem, Qt::TextSingleLine, text);
-        }
-        else
-        {
-            cy = rcStatus.bottom();
-            cx = rcItem.left() + maxWidth + 10;
+        const auto textStatus = ui->labelStatus->text();
+        auto rcStatus = painter.boundingRect(rc.left(), rc.top(), rc.width(), rc.height(), Qt::TextWordWrap, textStatus);
+        painter.drawText(rcStatus, Qt::TextWordWrap, textStatus);
 
-            rcItem = painter.boundingRect(cx, cy, rc.width() - cx, rc.height() - cy, Qt::TextSingleLine, text);
-            if(rcItem.right() > rc.right()) break;
+        rcStatus.setBottom(rcStatus.bottom() + 4);
+        painter.drawLine(rc.left(), rcStatus.bottom(), rc.right(), rcStatus.bottom());
+        top = rcStatus.bottom() + 4;
+    }
 
-            painter.drawText(rcItem, Qt::TextSingleLine, text);
-        }
+    auto text = [this](int i) {
+        return _listModel->data(_listModel->index(i), Qt::DisplayRole).toString();
+    };
 
-        cy += rcItem.height();
+    const auto fm = painter.fontMetrics();
+    const int cellHeight = fm.height();
+    const int spacing = 10;
+
+    const int rowsPerColumn = qMax(1, (rc.bottom() - top) / cellHeight);
+    const int columns = qMax(1, (rc.width() + spacing) / (cellWidth + spacing));
+    const int last = qMin(count, row + rowsPerColumn * columns);
+
+    for(int i = row; i < last; i++)
+    {
+        const int n = i - row;
+        const QRect rcItem(rc.left() + n / rowsPerColumn * (cellWidth + spacing),
+                           top + n % rowsPerColumn * cellHeight, cellWidth, cellHeight);
+
+        auto s = text(i);
+        s.truncate(trimmedLength(s));
+        painter.drawText(rcItem, Qt::TextSingleLine, s);
     }
+
+    row = last;
+    return row < count;
 }
 
 ///
@@ -638,10 +1147,65 @@ void OutputWidget::updateTraffic(const QModbusResponse& response, int deviceId,
 
 ///
 /// \brief OutputWidget::updateData
+/// \param data
+/// \return true if any value has changed
 ///
-void OutputWidget::updateData(const QModbusDataUnit& data)
+bool OutputWidget::updateData(const QModbusDataUnit& data)
 {
-    _listModel->updateData(data);
+    const bool changed = _listModel->updateData(data);
+
+    // the sparklines move on even when the values stay the same
+    if(_listModel->_history.size() > 0)
+        ui->dataView->viewport()->update();
+
+    return changed;
+}
+
+///
+/// \brief OutputWidget::historyDepth
+/// \return number of samples kept per row, 0 if there is no history
+///
+int OutputWidget::historyDepth() const
+{
+    return _displayDefinition.HistoryDepth;
+}
+
+///
+/// \brief OutputWidget::setHistoryDepth
+/// \param depth
+///
+void OutputWidget::setHistoryDepth(int depth)
+{
+    depth = qBound(0, depth, 4096);
+    if(depth == _displayDefinition.HistoryDepth)
+        return;
+
+    _displayDefinition.HistoryDepth = depth;
+    _listModel->resetHistory();
+    _listModel->update();
+}
+
+///
+/// \brief OutputWidget::updateHistory
+/// Keeps every received sample, unlike updateData that only sees the ones that get shown
+/// \param data
+///
+void OutputWidget::updateHistory(const QModbusDataUnit& data)
+{
+    _listModel->appendHistory(data);
+}
+
+///
+/// \brief OutputWidget::memoryUsage
+/// \return approximate number of bytes held by the data and the traffic log
+///
+qint64 OutputWidget::memoryUsage() const
+{
+    qint64 size = _listModel->memoryUsage() + ui->logView->memoryUsage();
+    for(auto&& desc : _descriptionMap)
+        size += sizeof(AddressDescriptionMap::key_type) + 3 * sizeof(void*) + desc.capacity() * sizeof(QChar);
+
+    return size;
 }
 
 ///
@@ -732,6 +1296,33 @@ void OutputWidget::setDataDisplayMode(DataDisplayMode mode)
     _listModel->update();
 }
 
+///
+/// \brief OutputWidget::extraColumns
+/// \return the modes shown next to the display mode
+///
+QVector<DataDisplayMode> OutputWidget::extraColumns() const
+{
+    return _extraColumns;
+}
+
+///
+/// \brief OutputWidget::setExtraColumns
+/// The columns are formatted from the same data as the display mode, no extra requests are made
+/// \param modes
+///
+void OutputWidget::setExtraColumns(const QVector<DataDisplayMode>& modes)
+{
+    _extraColumns.clear();
+    for(auto&& m : modes)
+    {
+        if(!_extraColumns.contains(m))
+            _extraColumns.append(m);
+    }
+
+    _listModel->resetColumns();
+    _listModel->update();
+}
+
 ///
 /// \brief OutputWidget::protocol
 /// \return
@@ -772,12 +1363,12 @@ void OutputWidget::setByteOrder(ByteOrder order)
 }
 
 ///
-/// \brief OutputWidget::on_listView_customContextMenuRequested
+/// \brief OutputWidget::on_dataView_customContextMenuRequested
 /// \param pos
 ///
-void OutputWidget::on_listView_customContextMenuRequested(const QPoint &pos)
+void OutputWidget::on_dataView_customContextMenuRequested(const QPoint &pos)
 {
-    const auto index = ui->listView->indexAt(pos);
+    const auto index = ui->dataView->indexAt(pos);
     if(!index.isValid()) return;
 
     QInputDialog dlg(this);
@@ -790,10 +1381,10 @@ void OutputWidget::on_listView_customContextMenuRequested(const QPoint &pos)
 }
 
 ///
-/// \brief OutputWidget::on_listView_doubleClicked
+/// \brief OutputWidget::on_dataView_doubleClicked
 /// \param index
 ///
-void OutputWidget::on_listView_doubleClicked(const QModelIndex& index)
+void OutputWidget::on_dataView_doubleClicked(const QModelIndex& index)
 {
     if(!index.isValid()) return;
 
@@ -882,14 +1473,15 @@ void OutputWidget::showModbusMessage(const QModelIndex& index)
 ///
 void OutputWidget::updateLogView(bool request, int server, int transactionId, const QModbusPdu& pdu)
 {
-    auto msg = ui->logView->addItem(pdu, _protocol, server, transactionId, QDateTime::currentDateTime(), request);
-    if(captureMode() == CaptureMode::TextCapture && msg != nullptr)
+    const auto timestamp = QDateTime::currentDateTime();
+    const auto index = ui->logView->addItem(pdu, _protocol, server, transactionId, timestamp, request);
+    if(captureMode() == CaptureMode::TextCapture && index.isValid())
     {
         const auto str = QString("%1: %2 %3 %4").arg(
-                (msg->isRequest()?  "Tx" : "Rx"),
-                msg->timestamp().toString(Qt::ISODateWithMs),
-                (msg->isRequest()?  "<<" : ">>"),
-                msg->toString(DataDisplayMode::Hex));
+                (request?  "Tx" : "Rx"),
+                timestamp.toString(Qt::ISODateWithMs),
+                (request?  "<<" : ">>"),
+                ui->logView->itemText(index, DataDisplayMode::Hex));
         captureString(str);
     }
 }
@@ -3,6 +3,7 @@
 
 #include <QFile>
 #include <QWidget>
+#include <QBitArray>
 #include <QDateTime>
 #include <QListWidgetItem>
 #include <QModbusReply>
@@ -10,6 +11,9 @@
 #include "modbusmessage.h"
 #include "datasimulator.h"
 #include "displaydefinition.h"
+#include "formatpipeline.h"
+#include "packedbits.h"
+#include "registerhistory.h"
 
 namespace Ui {
 class OutputWidget;
@@ -26,6 +30,7 @@ class OutputListModel : public QAbstractListModel
     Q_OBJECT
 
     friend class OutputWidget;
+    friend class OutputDataView;
 
 public:
     explicit OutputListModel(OutputWidget* parent);
@@ -39,25 +44,97 @@ public:
 
     void clear();
     void update();
-    void updateData(const QModbusDataUnit& data);
+    bool updateData(const QModbusDataUnit& data);
 
     QModelIndex find(QModbusDataUnit::RegisterType type, quint16 addr) const;
 
+    qint64 memoryUsage() const;
+
+signals:
+    void columnsReset();
+
 private:
-    struct ItemData
+    struct ValueCache
     {
-        quint32 Address = 0;
-        QVariant Value;
-        QString ValueStr;
-        QString Description;
-        bool Simulated = false;
+        quint64 Words = 0;
+        DataDisplayMode Mode = DataDisplayMode::Binary;
+        ByteOrder Order = ByteOrder::LittleEndian;
+        bool HexAddresses = false;
+        bool Valid = false;
     };
 
+    struct ColumnFormat
+    {
+        DataDisplayMode Mode = DataDisplayMode::Binary;
+        FormatPipeline Pipeline = nullptr;
+        int Decoded = -1;
+    };
+
+    void resizeRows();
+    bool updateBits(const QModbusDataUnit& data);
+    void resetHistory();
+    void appendHistory(const QModbusDataUnit& data);
+    int historySeries(int row, QVector<double>& values) const;
+    HistoryStatistics historyStatistics(int row) const;
+    void ensureDecoded() const;
+    void clearDecoded();
+    void resetColumns();
+    QVector<DataDisplayMode> extraColumnModes() const;
+    QString columnText(int row, int column) const;
+    int valueStep() const;
+    void formatRow(int row) const;
+    QString cellText(int row) const;
+    QString pointText(int row, QVariant& value) const;
+    quint64 valueWords(int row, int step) const;
+
+    quint32 address(int row) const;
+
+    bool isBitType() const;
+
+    bool bit(int row) const {
+        return row < _bits.size() && _bits.testBit(row);
+    }
+
+    bool bitChanged(int row) const {
+        return row < _changedBits.size() && _changedBits.testBit(row);
+    }
+
+    QString description(int row) const {
+        const auto id = _descriptionIds[row];
+        return id < 0 ? QString() : _descriptions[id];
+    }
+
+private:
     OutputWidget* _parentWidget;
+
+    // of coils and discrete inputs only the header is kept, their values are in _bits
     QModbusDataUnit _lastData;
+    RegisterHistory _history;
+
+    // coils and discrete inputs, the bits of the last update that differ from the update before
+    PackedBits _bits;
+    PackedBits _changedBits;
     QIcon _iconPointGreen;
     QIcon _iconPointEmpty;
-    QMap<int, ItemData> _mapItems;
+
+    // one entry per row, the raw words are the ones of _lastData
+    QBitArray _simulated;
+    QVector<int> _descriptionIds;
+    QStringList _descriptions;
+
+    // formatted on demand
+    mutable QVector<QVariant> _values;
+    mutable QVector<QString> _valueStrs;
+    mutable QVector<QString> _displayStrs;
+    mutable QVector<ValueCache> _cache;
+    mutable DecodedRegisters _decoded;
+    mutable FormatPipeline _pipeline = nullptr;
+    mutable BitPipeline _bitPipeline = nullptr;
+
+    // the extra columns share the decoded values of modes with the same layout
+    mutable QVector<ColumnFormat> _columns;
+    mutable QVector<DecodedRegisters> _columnDecoded;
+    mutable bool _columnsDecoded = false;
 };
 
 ///
@@ -83,6 +160,9 @@ public:
     DataDisplayMode dataDisplayMode() const;
     void setDataDisplayMode(DataDisplayMode mode);
 
+    QVector<DataDisplayMode> extraColumns() const;
+    void setExtraColumns(const QVector<DataDisplayMode>& modes);
+
     ModbusMessage::ProtocolType protocol() const;
     void setProtocol(ModbusMessage::ProtocolType type);
 
@@ -113,29 +193,38 @@ public:
 
     void setStatus(const QString& status);
 
-    void paint(const QRect& rc, QPainter& painter);
+    int printCellWidth(const QFontMetrics& fm) const;
+    bool paint(const QRect& rc, QPainter& painter, int& row, int cellWidth);
 
     void updateTraffic(const QModbusRequest& request, int server, int transactionId);
     void updateTraffic(const QModbusResponse& response, int server, int transactionId);
-    void updateData(const QModbusDataUnit& data);
+    bool updateData(const QModbusDataUnit& data);
+
+    int historyDepth() const;
+    void setHistoryDepth(int depth);
+    void updateHistory(const QModbusDataUnit& data);
 
     AddressDescriptionMap descriptionMap() const;
     void setDescription(QModbusDataUnit::RegisterType type, quint16 addr, const QString& desc);
 
     void setSimulated(QModbusDataUnit::RegisterType type, quint16 addr, bool on);
 
+    qint64 memoryUsage() const;
+
 public slots:
     void clearLogView();
 
 signals:
     void itemDoubleClicked(quint16 address, const QVariant& value);
+    void dataPainted();
 
 protected:
     void changeEvent(QEvent* event) override;
+    bool eventFilter(QObject* obj, QEvent* event) override;
 
 private slots:
-    void on_listView_doubleClicked(const QModelIndex& index);
-    void on_listView_customContextMenuRequested(const QPoint &pos);
+    void on_dataView_doubleClicked(const QModelIndex& index);
+    void on_dataView_customContextMenuRequested(const QPoint &pos);
 
 private:
     void setUninitializedStatus();
@@ -150,6 +239,7 @@ private:
     bool _displayHexAddresses;
     DisplayMode _displayMode;
     DataDisplayMode _dataDisplayMode;
+    QVector<DataDisplayMode> _extraColumns;
     ModbusMessage::ProtocolType _protocol;
     ByteOrder _byteOrder;
     DisplayDefinition _displayDefinition;
@@ -0,0 +1,120 @@
+#include <QPainter>
+#include <QPainterPath>
+#include <QVarLengthArray>
+#include "sparklinewidget.h"
+
+///
+/// \brief SparklineWidget::SparklineWidget
+/// \param parent
+///
+SparklineWidget::SparklineWidget(QWidget* parent)
+    : QWidget(parent)
+    ,_maximum(0)
+{
+}
+
+///
+/// \brief SparklineWidget::setValues
+/// \param values
+///
+void SparklineWidget::setValues(const QVector<double>& values)
+{
+    _values = values;
+    update();
+}
+
+///
+/// \brief SparklineWidget::setMaximum
+/// \param max fixed upper bound of the scale, or 0 to scale to the largest value
+///
+void SparklineWidget::setMaximum(double max)
+{
+    _maximum = max;
+    update();
+}
+
+///
+/// \brief SparklineWidget::sizeHint
+/// \return
+///
+QSize SparklineWidget::sizeHint() const
+{
+    return QSize(60, fontMetrics().height());
+}
+
+///
+/// \brief SparklineWidget::paintEvent
+///
+void SparklineWidget::paintEvent(QPaintEvent*)
+{
+    if(_values.size() < 2)
+        return;
+
+    auto max = _maximum;
+    if(max <= 0)
+    {
+        for(auto&& v : _values)
+            max = qMax(max, v);
+    }
+    if(max <= 0) max = 1;
+
+    QPainter painter(this);
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.setPen(QPen(palette().highlight().color(), 1));
+    drawSparkline(painter, QRectF(rect()).adjusted(1, 1, -1, -1), _values.constData(), _values.size(), 0, max);
+}
+
+///
+/// \brief SparklineWidget::drawSparkline
+/// Draws the values scaled from min to max with the pen of the painter. When there are
+/// more values than pixels every pixel column shows the range of the values it covers.
+/// \param painter
+/// \param rc
+/// \param values
+/// \param count
+/// \param min
+/// \param max
+///
+void SparklineWidget::drawSparkline(QPainter& painter, const QRectF& rc, const double* values, int count, double min, double max)
+{
+    if(count < 2 || rc.width() < 2)
+        return;
+
+    const double range = (max > min) ? max - min : 1;
+    auto y = [&](double v) {
+        return rc.bottom() - qBound(0.0, (v - min) / range, 1.0) * rc.height();
+    };
+
+    const int columns = int(rc.width());
+    if(count <= columns)
+    {
+        const auto dx = rc.width() / (count - 1);
+
+        QPainterPath path;
+        path.moveTo(rc.left(), y(values[0]));
+        for(int i = 1; i < count; i++)
+            path.lineTo(rc.left() + i * dx, y(values[i]));
+
+        painter.drawPath(path);
+        return;
+    }
+
+    QVarLengthArray<QLineF, 256> lines;
+    for(int c = 0; c < columns; c++)
+    {
+        const int first = int(qint64(c) * count / columns);
+        const int last = qMax(first + 1, int(qint64(c + 1) * count / columns));
+
+        double lo = values[first], hi = values[first];
+        for(int i = first + 1; i < last; i++)
+        {
+            lo = qMin(lo, values[i]);
+            hi = qMax(hi, values[i]);
+        }
+
+        const auto x = rc.left() + c + 0.5;
+        lines.append(QLineF(x, y(lo), x, y(hi)));
+    }
+
+    painter.drawLines(lines.constData(), lines.size());
+}
@@ -0,0 +1,33 @@
+#ifndef SPARKLINEWIDGET_H
+#define SPARKLINEWIDGET_H
+
+#include <QWidget>
+
+class QPainter;
+
+///
+/// \brief The SparklineWidget class
+///
+class SparklineWidget : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit SparklineWidget(QWidget* parent = nullptr);
+
+    void setValues(const QVector<double>& values);
+    void setMaximum(double max);
+
+    QSize sizeHint() const override;
+
+    static void drawSparkline(QPainter& painter, const QRectF& rc, const double* values, int count, double min, double max);
+
+protected:
+    void paintEvent(QPaintEvent* event) override;
+
+private:
+    double _maximum;
+    QVector<double> _values;
+};
+
+#endif // SPARKLINEWIDGET_H
@@ -1,6 +1,16 @@
+#include <QEvent>
+#include <QToolTip>
+#include <QHelpEvent>
+#include "formatutils.h"
 #include "statisticwidget.h"
 #include "ui_statisticwidget.h"
 
+///
+/// \brief UpdateInterval
+/// Milliseconds the labels wait for more samples before they are refreshed
+///
+static constexpr int UpdateInterval = 250;
+
 ///
 /// \brief StatisticWidget::StatisticWidget
 /// \param parent
@@ -10,8 +20,26 @@ StatisticWidget::StatisticWidget(QWidget *parent) :
     , ui(new Ui::StatisticWidget)
     ,_numberOfPolls(0)
     ,_validSlaveResponses(0)
+    ,_timeouts(0)
+    ,_exceptions(0)
 {
     ui->setupUi(this);
+
+    _updateTimer.setSingleShot(true);
+    _updateTimer.setInterval(UpdateInterval);
+    connect(&_updateTimer, &QTimer::timeout, this, &StatisticWidget::updateStatistic);
+
+    updateStatistic();
+}
+
+///
+/// \brief formatMsecs
+/// \param usecs
+/// \return
+///
+static QString formatMsecs(double usecs)
+{
+    return QLocale().toString(usecs / 1000.0, 'f', 1);
 }
 
 ///
@@ -22,6 +50,23 @@ StatisticWidget::~StatisticWidget()
     delete ui;
 }
 
+///
+/// \brief StatisticWidget::event
+/// \param event
+/// \return
+///
+bool StatisticWidget::event(QEvent* event)
+{
+    if(event->type() == QEvent::ToolTip && (_responseTime.count() > 0 || _timerLateness.count() > 0))
+    {
+        auto helpEvent = static_cast<QHelpEvent*>(event);
+        QToolTip::showText(helpEvent->globalPos(), breakdownText(), this);
+        return true;
+    }
+
+    return QWidget::event(event);
+}
+
 ///
 /// \brief StatisticWidget::changeEvent
 /// \param event
@@ -31,6 +76,7 @@ void StatisticWidget::changeEvent(QEvent* event)
     if (event->type() == QEvent::LanguageChange)
     {
         ui->retranslateUi(this);
+        updateStatistic();
     }
 
     QWidget::changeEvent(event);
@@ -42,7 +88,7 @@ void StatisticWidget::changeEvent(QEvent* event)
 void StatisticWidget::increaseNumberOfPolls()
 {
     _numberOfPolls++;
-    updateStatistic();
+    scheduleUpdate();
 
     emit numberOfPollsChanged(_numberOfPolls);
 }
@@ -53,11 +99,56 @@ void StatisticWidget::increaseNumberOfPolls()
 void StatisticWidget::increaseValidSlaveResponses()
 {
    _validSlaveResponses++;
-   updateStatistic();
+   scheduleUpdate();
 
    emit validSlaveResposesChanged(_validSlaveResponses);
 }
 
+///
+/// \brief StatisticWidget::addResponseTime
+/// \param deviceId
+/// \param functionCode
+/// \param usecs
+///
+void StatisticWidget::addResponseTime(int deviceId, int functionCode, qint64 usecs)
+{
+    if(usecs < 0) return;
+
+    _responseTime.record(usecs);
+    _deviceResponseTime[deviceId].record(usecs);
+    _functionResponseTime[functionCode].record(usecs);
+
+    scheduleUpdate();
+}
+
+///
+/// \brief StatisticWidget::increaseTimeouts
+///
+void StatisticWidget::increaseTimeouts()
+{
+    _timeouts++;
+    scheduleUpdate();
+}
+
+///
+/// \brief StatisticWidget::increaseExceptions
+///
+void StatisticWidget::increaseExceptions()
+{
+    _exceptions++;
+    scheduleUpdate();
+}
+
+///
+/// \brief StatisticWidget::addTimerLateness
+/// \param usecs how late the scan timer fired past its deadline, early ticks count as 0
+///
+void StatisticWidget::addTimerLateness(qint64 usecs)
+{
+    _timerLateness.record(qMax<qint64>(0, usecs));
+    scheduleUpdate();
+}
+
 ///
 /// \brief StatisticWidget::resetCtrls
 ///
@@ -65,6 +156,12 @@ void StatisticWidget::resetCtrs()
 {
     _numberOfPolls = 0;
     _validSlaveResponses = 0;
+    _timeouts = 0;
+    _exceptions = 0;
+    _responseTime.reset();
+    _timerLateness.reset();
+    _deviceResponseTime.clear();
+    _functionResponseTime.clear();
 
     updateStatistic();
 
@@ -81,6 +178,16 @@ void StatisticWidget::on_pushButtonResetCtrs_clicked()
     emit ctrsReseted();
 }
 
+///
+/// \brief StatisticWidget::scheduleUpdate
+/// Samples arrive with every poll, the labels and percentiles are refreshed a few times a second at most
+///
+void StatisticWidget::scheduleUpdate()
+{
+    if(!_updateTimer.isActive())
+        _updateTimer.start();
+}
+
 ///
 /// \brief StatisticWidget::updateStatistic
 ///
@@ -88,4 +195,45 @@ void StatisticWidget::updateStatistic()
 {
     ui->labelNumberOfPolls->setText(QString(tr("Number of Polls: %1")).arg(_numberOfPolls));
     ui->labelValidSlaveResponses->setText(QString(tr("Valid Slave Responses: %1")).arg(_validSlaveResponses));
+    ui->labelResponseTime->setText(QString(tr("Response Time: %1 / %2 / %3 ms")).arg(formatMsecs(_responseTime.min()),
+                                                                                    formatMsecs(_responseTime.mean()),
+                                                                                    formatMsecs(_responseTime.max())));
+    ui->labelPercentiles->setText(QString(tr("Percentiles: %1 / %2 / %3 ms")).arg(formatMsecs(_responseTime.percentile(50)),
+                                                                                 formatMsecs(_responseTime.percentile(95)),
+                                                                                 formatMsecs(_responseTime.percentile(99))));
+    ui->labelTimerLateness->setText(QString(tr("Scan Lateness: %1 / %2 / %3 ms")).arg(formatMsecs(_timerLateness.percentile(50)),
+                                                                                     formatMsecs(_timerLateness.percentile(99)),
+                                                                                     formatMsecs(_timerLateness.max())));
+    ui->labelErrors->setText(QString(tr("Timeouts: %1  Exceptions: %2")).arg(QString::number(_timeouts),
+                                                                            QString::number(_exceptions)));
+}
+
+///
+/// \brief StatisticWidget::breakdownText
+/// \return
+///
+QString StatisticWidget::breakdownText() const
+{
+    const auto line = [](const QString& name, const LatencyHistogram& h) {
+        return QString("<tr><td>%1</td><td align=right>%2</td><td align=right>%3</td><td align=right>%4</td>"
+                       "<td align=right>%5</td><td align=right>%6</td><td align=right>%7</td></tr>")
+            .arg(name, QString::number(h.count()), formatMsecs(h.min()), formatMsecs(h.mean()),
+                 formatMsecs(h.percentile(50)), formatMsecs(h.percentile(99)), formatMsecs(h.max()));
+    };
+
+    QString text = "<table cellspacing=4>";
+    text += QString("<tr><th></th><th>%1</th><th>%2</th><th>%3</th><th>p50</th><th>p99</th><th>%4</th></tr>")
+                .arg(tr("Count"), tr("Min"), tr("Avg"), tr("Max"));
+
+    for(auto it = _deviceResponseTime.cbegin(); it != _deviceResponseTime.cend(); ++it)
+        text += line(QString(tr("Device Id %1")).arg(it.key()), it.value());
+
+    for(auto it = _functionResponseTime.cbegin(); it != _functionResponseTime.cend(); ++it)
+        text += line(QString(tr("Function %1")).arg(formatUInt8Value(DataDisplayMode::Hex, it.key())), it.value());
+
+    if(_timerLateness.count() > 0)
+        text += line(tr("Scan Lateness"), _timerLateness);
+
+    text += "</table>";
+    return text;
 }
@@ -1,7 +1,10 @@
 #ifndef STATISTICWIDGET_H
 #define STATISTICWIDGET_H
 
+#include <QMap>
+#include <QTimer>
 #include <QWidget>
+#include "latencyhistogram.h"
 
 namespace Ui {
 class StatisticWidget;
@@ -25,19 +28,32 @@ public:
     void increaseValidSlaveResponses();
     void resetCtrs();
 
+    uint timeouts() const { return _timeouts; }
+    uint exceptions() const { return _exceptions; }
+    const LatencyHistogram& responseTime() const { return _responseTime; }
+    const LatencyHistogram& timerLateness() const { return _timerLateness; }
+
+    void addResponseTime(int deviceId, int functionCode, qint64 usecs);
+    void increaseTimeouts();
+    void increaseExceptions();
+    void addTimerLateness(qint64 usecs);
+
 signals:
     void numberOfPollsChanged(uint value);
     void validSlaveResposesChanged(uint value);
     void ctrsReseted();
 
 protected:
+    bool event(QEvent* event) override;
     void changeEvent(QEvent* event) override;
 
 private slots:
     void on_pushButtonResetCtrs_clicked();
 
 private:
+    void scheduleUpdate();
     void updateStatistic();
+    QString breakdownText() const;
 
 private:
     Ui::StatisticWidget *ui;
@@ -45,6 +61,13 @@ private:
 private:
     uint _numberOfPolls;
     uint _validSlaveResponses;
+    uint _timeouts;
+    uint _exceptions;
+    LatencyHistogram _responseTime;
+    LatencyHistogram _timerLateness;
+    QMap<int, LatencyHistogram> _deviceResponseTime;
+    QMap<int, LatencyHistogram> _functionResponseTime;
+    QTimer _updateTimer;
 };
 
 #endif // STATISTICWIDGET_H
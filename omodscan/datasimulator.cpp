@@ -391,3 +391,14 @@ void DataSimulator::toggleSimulation(QModbusDataUnit::RegisterType type, quint16
 
     emit dataSimulated(DataDisplayMode::Binary, type, addr, deviceId, value);
 }
+
+///
+/// \brief DataSimulator::memoryUsage
+/// \return approximate number of bytes held by the running simulations
+///
+qint64 DataSimulator::memoryUsage() const
+{
+    // map node: key, value and the two links of the red-black tree
+    constexpr qint64 nodeSize = sizeof(SimulationKey) + sizeof(SimulationParams) + 3 * sizeof(void*);
+    return _simulationMap.size() * nodeSize;
+}
@@ -29,6 +29,8 @@ public:
     ModbusSimulationParams simulationParams(QModbusDataUnit::RegisterType type, quint16 addr, quint8 deviceId) const;
     ModbusSimulationMap simulationMap(quint8 deviceId) const;
 
+    qint64 memoryUsage() const;
+
 signals:
     void simulationStarted(QModbusDataUnit::RegisterType type, quint16 addr, quint8 deviceId);
     void simulationStopped(QModbusDataUnit::RegisterType type, quint16 addr, quint8 deviceId);
@@ -2,6 +2,7 @@
 #include <QtWidgets>
 #include <QtPrintSupport>
 #include "modbuslimits.h"
+#include "memorybudget.h"
 #include "dialogaddressscan.h"
 #include "ui_dialogaddressscan.h"
 
@@ -203,7 +204,7 @@ LogViewModel::LogViewModel(QObject* parent)
 ///
 LogViewModel::~LogViewModel()
 {
-    void deleteItems();
+    deleteItems();
 }
 
 ///
@@ -271,6 +272,52 @@ void LogViewModel::setAddressBase(AddressBase base)
     _addressBase = base;
 }
 
+///
+/// \brief LogViewModel::append
+/// \param addr
+/// \param type
+/// \param msg
+///
+void LogViewModel::append(quint16 addr, QModbusDataUnit::RegisterType type, const ModbusMessage* msg)
+{
+    if(msg == nullptr) return;
+
+    const auto size = msg->memoryUsage();
+    if(!_items.isEmpty() && MemoryBudget::instance().wouldExceed(size))
+        removeOldest(size);
+
+    beginInsertRows(QModelIndex(), rowCount(), rowCount());
+    _items.push_back({ addr, type, msg });
+    _memoryUsage += size;
+    MemoryBudget::instance().allocate(size);
+    endInsertRows();
+}
+
+///
+/// \brief LogViewModel::removeOldest
+/// Drops the oldest entries until the given amount fits into the memory budget
+/// \param bytes
+///
+void LogViewModel::removeOldest(qint64 bytes)
+{
+    int count = 0;
+    qint64 freed = 0;
+    while(count < _items.size() && MemoryBudget::instance().wouldExceed(bytes - freed))
+        freed += _items.at(count++).Msg->memoryUsage();
+
+    if(count == 0)
+        return;
+
+    beginRemoveRows(QModelIndex(), 0, count - 1);
+    for(int i = 0; i < count; i++)
+        delete _items.at(i).Msg;
+
+    _items.remove(0, count);
+    _memoryUsage -= freed;
+    MemoryBudget::instance().release(freed);
+    endRemoveRows();
+}
+
 ///
 /// \brief LogViewModel::deleteItems
 ///
@@ -280,6 +327,9 @@ void LogViewModel::deleteItems()
             delete i.Msg;
 
     _items.clear();
+
+    MemoryBudget::instance().release(_memoryUsage);
+    _memoryUsage = 0;
 }
 
 ///
@@ -351,6 +401,15 @@ DialogAddressScan::DialogAddressScan(const DisplayDefinition& dd, DataDisplayMod
     connect(&_modbusClient, &ModbusClient::modbusReply, this, &DialogAddressScan::on_modbusReply);
     connect(&_modbusClient, &ModbusClient::modbusRequest, this, &DialogAddressScan::on_modbusRequest);
     connect(proxyLogModel->sourceModel(), &LogViewModel::rowsInserted, ui->logView, &QListView::scrollToBottom);
+    connect(proxyLogModel->sourceModel(), &LogViewModel::rowsAboutToBeRemoved, this, [&](const QModelIndex&, int first, int last) {
+        // the oldest messages are dropped when the memory budget is hit
+        const auto sourceModel = ((LogViewProxyModel*)ui->logView->model())->sourceModel();
+        for(int row = first; row <= last; row++)
+        {
+            if(sourceModel->index(row, 0).data(Qt::UserRole).value<const ModbusMessage*>() == ui->info->modbusMessage())
+                ui->info->clear();
+        }
+    });
 
     clearTableView();
 }
@@ -588,6 +647,21 @@ void DialogAddressScan::startScan()
         return;
     }
 
+    const auto required = estimateLogMemoryUsage();
+    const auto logMemoryUsage = ((LogViewProxyModel*)ui->logView->model())->memoryUsage();
+    if(MemoryBudget::instance().wouldExceed(required - logMemoryUsage))
+    {
+        const auto locale = QLocale();
+        const auto ret = QMessageBox::question(this, windowTitle(),
+                                               tr("The scan log needs about %1, but only %2 of the memory budget is available.\n"
+                                                  "The oldest log entries will be dropped during the scan. Continue?")
+                                                   .arg(locale.formattedDataSize(required),
+                                                        locale.formattedDataSize(qMax<qint64>(0, MemoryBudget::instance().budget() - MemoryBudget::instance().used() + logMemoryUsage))),
+                                               QMessageBox::Yes | QMessageBox::No);
+        if(ret != QMessageBox::Yes)
+            return;
+    }
+
     _scanning = true;
     _finished = false;
 
@@ -600,6 +674,26 @@ void DialogAddressScan::startScan()
     _scanTimer.start(1000);
 }
 
+///
+/// \brief DialogAddressScan::estimateLogMemoryUsage
+/// \return approximate number of bytes the log of a full scan takes
+///
+qint64 DialogAddressScan::estimateLogMemoryUsage() const
+{
+    const auto length = ui->lineEditLength->value<int>();
+    const auto count = ui->spinBoxRegsOnQuery->value();
+    const auto pointType = ui->comboBoxPointType->currentPointType();
+    const bool isBits = (pointType == QModbusDataUnit::Coils || pointType == QModbusDataUnit::DiscreteInputs);
+
+    // MBAP header, function code, address and quantity
+    constexpr int requestSize = 7 + 1 + 4;
+    // MBAP header, function code, byte count and values
+    const int responseSize = 7 + 1 + 1 + (isBits ? (count + 7) / 8 : count * 2);
+
+    const qint64 requests = (length + count - 1) / count;
+    return requests * (ModbusMessage::estimateMemoryUsage(requestSize) + ModbusMessage::estimateMemoryUsage(responseSize));
+}
+
 ///
 /// \brief DialogAddressScan::stopScan
 ///
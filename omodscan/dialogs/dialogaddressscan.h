@@ -82,12 +82,7 @@ public:
     AddressBase addressBse() const;
     void setAddressBase(AddressBase base);
 
-    void append(quint16 addr, QModbusDataUnit::RegisterType type, const ModbusMessage* msg) {
-        if(msg == nullptr) return;
-        beginInsertRows(QModelIndex(), rowCount(), rowCount());
-        _items.push_back({ addr, type, msg });
-        endInsertRows();
-    }
+    void append(quint16 addr, QModbusDataUnit::RegisterType type, const ModbusMessage* msg);
 
     void clear() {
         beginResetModel();
@@ -101,7 +96,12 @@ public:
         endResetModel();
     }
 
+    qint64 memoryUsage() const {
+        return _memoryUsage;
+    }
+
 private:
+    void removeOldest(qint64 bytes);
     void deleteItems();
 
 private:
@@ -115,6 +115,7 @@ private:
     bool _hexView = false;
     AddressBase _addressBase = AddressBase::Base1;
     QVector<LogViewItem> _items;
+    qint64 _memoryUsage = 0;
 };
 
 ///
@@ -137,6 +138,10 @@ public:
             ((LogViewModel*)sourceModel())->clear();
     }
 
+    qint64 memoryUsage() const {
+        return sourceModel() ? ((LogViewModel*)sourceModel())->memoryUsage() : 0;
+    }
+
     void setAddressBase(AddressBase base) {
         if(sourceModel())
             ((LogViewModel*)sourceModel())->setAddressBase(base);
@@ -270,6 +275,7 @@ private slots:
 private:
     void startScan();
     void stopScan();
+    qint64 estimateLogMemoryUsage() const;
 
     void sendReadRequest();
 
@@ -0,0 +1,245 @@
+#include <QFile>
+#include <QEvent>
+#include <QCloseEvent>
+#include <QTextStream>
+#include <QFileDialog>
+#include <QMessageBox>
+#include <QAbstractEventDispatcher>
+#include "dialogburstpolling.h"
+#include "ui_dialogburstpolling.h"
+
+///
+/// \brief formatNsecs
+/// \param ns
+/// \return
+///
+static QString formatNsecs(double ns)
+{
+    return QString("%1 %2").arg(QLocale().toString(ns / 1e6, 'f', 3), DialogBurstPolling::tr("ms"));
+}
+
+///
+/// \brief DialogBurstPolling::DialogBurstPolling
+/// \param frm
+/// \param parent
+///
+DialogBurstPolling::DialogBurstPolling(FormModSca* frm, QWidget *parent)
+    : QFixedSizeDialog(parent)
+    , ui(new Ui::DialogBurstPolling)
+    ,_form(frm)
+{
+    Q_ASSERT(frm != nullptr);
+
+    ui->setupUi(this);
+    setWindowTitle(QString("%1 - %2").arg(windowTitle(), frm->windowTitle()));
+
+    ui->lineEditDuration->setInputRange(100, 3600000);
+    ui->lineEditDuration->setValue(_params.Duration);
+    ui->lineEditSamples->setInputRange(1, 1000000);
+    ui->lineEditSamples->setValue(_params.Samples);
+    ui->radioButtonDuration->setChecked(true);
+    ui->progressBar->setVisible(false);
+
+    auto dispatcher = QAbstractEventDispatcher::instance();
+    connect(dispatcher, &QAbstractEventDispatcher::awake, this, &DialogBurstPolling::on_awake);
+
+    connect(frm, &FormModSca::burstPollingProgress, this, &DialogBurstPolling::on_burstPollingProgress);
+    connect(frm, &FormModSca::burstPollingFinished, this, &DialogBurstPolling::on_burstPollingFinished);
+
+    clearResult();
+}
+
+///
+/// \brief DialogBurstPolling::~DialogBurstPolling
+///
+DialogBurstPolling::~DialogBurstPolling()
+{
+    delete ui;
+}
+
+///
+/// \brief DialogBurstPolling::changeEvent
+/// \param event
+///
+void DialogBurstPolling::changeEvent(QEvent* event)
+{
+    if (event->type() == QEvent::LanguageChange)
+    {
+        ui->retranslateUi(this);
+        updateResult();
+    }
+
+    QFixedSizeDialog::changeEvent(event);
+}
+
+///
+/// \brief DialogBurstPolling::closeEvent
+/// \param event
+///
+void DialogBurstPolling::closeEvent(QCloseEvent* event)
+{
+    if(_form && _form->isBurstPolling())
+        _form->stopBurstPolling();
+
+    QFixedSizeDialog::closeEvent(event);
+}
+
+///
+/// \brief DialogBurstPolling::on_awake
+///
+void DialogBurstPolling::on_awake()
+{
+    const bool polling = _form && _form->isBurstPolling();
+
+    ui->radioButtonDuration->setEnabled(!polling);
+    ui->radioButtonSamples->setEnabled(!polling);
+    ui->lineEditDuration->setEnabled(!polling && ui->radioButtonDuration->isChecked());
+    ui->lineEditSamples->setEnabled(!polling && ui->radioButtonSamples->isChecked());
+    ui->pushButtonStart->setEnabled(_form != nullptr);
+    ui->pushButtonStart->setText(polling ? tr("Stop") : tr("Start"));
+    ui->pushButtonExport->setEnabled(!polling && !_result.Samples.isEmpty());
+    ui->progressBar->setVisible(polling);
+}
+
+///
+/// \brief DialogBurstPolling::on_radioButtonDuration_toggled
+/// \param checked
+///
+void DialogBurstPolling::on_radioButtonDuration_toggled(bool checked)
+{
+    _params.Mode = checked ? BurstPollingMode::Duration : BurstPollingMode::Samples;
+}
+
+///
+/// \brief DialogBurstPolling::on_pushButtonStart_clicked
+///
+void DialogBurstPolling::on_pushButtonStart_clicked()
+{
+    if(!_form) return;
+
+    if(_form->isBurstPolling())
+    {
+        _form->stopBurstPolling();
+        return;
+    }
+
+    _params.Duration = ui->lineEditDuration->value<int>();
+    _params.Samples = ui->lineEditSamples->value<int>();
+    _params.normalize();
+
+    clearResult();
+    ui->progressBar->setValue(0);
+
+    _elapsed.start();
+    switch(_form->startBurstPolling(_params))
+    {
+        case BurstPollingError::NoError:
+        break;
+
+        case BurstPollingError::NotConnected:
+            QMessageBox::warning(this, windowTitle(), tr("No connection to MODBUS device!"));
+        break;
+
+        case BurstPollingError::InvalidRange:
+            QMessageBox::warning(this, windowTitle(), tr("Invalid data length specified!"));
+        break;
+
+        case BurstPollingError::AlreadyActive:
+            QMessageBox::warning(this, windowTitle(), tr("Burst polling is already running!"));
+        break;
+
+        case BurstPollingError::RequestFailed:
+            QMessageBox::warning(this, windowTitle(), tr("The request could not be sent to the MODBUS device!"));
+        break;
+    }
+}
+
+///
+/// \brief DialogBurstPolling::on_pushButtonExport_clicked
+///
+void DialogBurstPolling::on_pushButtonExport_clicked()
+{
+    auto filename = QFileDialog::getSaveFileName(this, QString(), QString(), tr("CSV files (*.csv)"));
+    if(filename.isEmpty()) return;
+
+    if(!filename.endsWith(".csv", Qt::CaseInsensitive))
+        filename += ".csv";
+
+    exportCsv(filename);
+}
+
+///
+/// \brief DialogBurstPolling::on_burstPollingProgress
+/// \param samples
+///
+void DialogBurstPolling::on_burstPollingProgress(int samples)
+{
+    const auto progress = (_params.Mode == BurstPollingMode::Samples) ?
+                              100.0 * samples / _params.Samples :
+                              100.0 * _elapsed.elapsed() / _params.Duration;
+
+    ui->progressBar->setValue(qBound(0, (int)progress, 100));
+}
+
+///
+/// \brief DialogBurstPolling::on_burstPollingFinished
+/// \param result
+///
+void DialogBurstPolling::on_burstPollingFinished(const BurstPollingResult& result)
+{
+    _result = result;
+    updateResult();
+}
+
+///
+/// \brief DialogBurstPolling::clearResult
+///
+void DialogBurstPolling::clearResult()
+{
+    _result = BurstPollingResult();
+    updateResult();
+}
+
+///
+/// \brief DialogBurstPolling::updateResult
+///
+void DialogBurstPolling::updateResult()
+{
+    ui->labelSamplesValue->setText(QString::number(_result.Samples.size()));
+    ui->labelValidSamplesValue->setText(QString::number(_result.validSamples()));
+    ui->labelElapsedValue->setText(formatNsecs(_result.elapsed()));
+    ui->labelRateValue->setText(QLocale().toString(_result.samplesPerSecond(), 'f', 1));
+    ui->labelRoundTripValue->setText(formatNsecs(_result.meanRoundTripTime()));
+    ui->labelIntervalValue->setText(QString("%1 (%2 / %3)").arg(formatNsecs(_result.meanInterval()),
+                                                                 formatNsecs(_result.minInterval()),
+                                                                 formatNsecs(_result.maxInterval())));
+    ui->labelJitterValue->setText(formatNsecs(_result.jitter()));
+}
+
+///
+/// \brief DialogBurstPolling::exportCsv
+/// \param filename
+///
+void DialogBurstPolling::exportCsv(const QString& filename)
+{
+    QFile file(filename);
+    if(!file.open(QFile::WriteOnly))
+        return;
+
+    QTextStream ts(&file);
+    ts.setGenerateByteOrderMark(true);
+
+    const char* delim = ";";
+    ts << QString("%2%1%3%1%4%1%5%1%6").arg(delim, tr("Sample"), tr("Request Time (us)"), tr("Response Time (us)"),
+                                           tr("Round-Trip Time (us)"), tr("Valid")) << "\n";
+
+    for(int i = 0; i < _result.Samples.size(); i++)
+    {
+        const auto& s = _result.Samples.at(i);
+        ts << (i + 1) << delim
+           << s.RequestTime / 1000 << delim
+           << s.ResponseTime / 1000 << delim
+           << s.roundTripTime() / 1000 << delim
+           << (s.Valid ? 1 : 0) << "\n";
+    }
+}
@@ -0,0 +1,51 @@
+#ifndef DIALOGBURSTPOLLING_H
+#define DIALOGBURSTPOLLING_H
+
+#include <QPointer>
+#include <QElapsedTimer>
+#include "qfixedsizedialog.h"
+#include "formmodsca.h"
+
+namespace Ui {
+class DialogBurstPolling;
+}
+
+///
+/// \brief The DialogBurstPolling class
+///
+class DialogBurstPolling : public QFixedSizeDialog
+{
+    Q_OBJECT
+
+public:
+    explicit DialogBurstPolling(FormModSca* frm, QWidget *parent = nullptr);
+    ~DialogBurstPolling();
+
+protected:
+    void changeEvent(QEvent* event) override;
+    void closeEvent(QCloseEvent* event) override;
+
+private slots:
+    void on_awake();
+    void on_radioButtonDuration_toggled(bool checked);
+    void on_pushButtonStart_clicked();
+    void on_pushButtonExport_clicked();
+    void on_burstPollingProgress(int samples);
+    void on_burstPollingFinished(const BurstPollingResult& result);
+
+private:
+    void clearResult();
+    void updateResult();
+    void exportCsv(const QString& filename);
+
+private:
+    Ui::DialogBurstPolling *ui;
+
+private:
+    QPointer<FormModSca> _form;
+    BurstPollingParams _params;
+    BurstPollingResult _result;
+    QElapsedTimer _elapsed;
+};
+
+#endif // DIALOGBURSTPOLLING_H
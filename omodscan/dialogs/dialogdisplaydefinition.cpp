@@ -19,6 +19,7 @@ DialogDisplayDefinition::DialogDisplayDefinition(DisplayDefinition dd, QWidget*
     ui->lineEditLength->setInputRange(ModbusLimits::lengthRange());
     ui->lineEditSlaveAddress->setInputRange(ModbusLimits::slaveRange());
     ui->lineEditLogLimit->setInputRange(4, 1000);
+    ui->lineEditHistoryDepth->setInputRange(0, 4096);
 
     ui->comboBoxAddressBase->setCurrentAddressBase(dd.ZeroBasedAddress ? AddressBase::Base0 : AddressBase::Base1);
     ui->comboBoxPointType->setCurrentPointType(dd.PointType);
@@ -27,6 +28,7 @@ DialogDisplayDefinition::DialogDisplayDefinition(DisplayDefinition dd, QWidget*
     ui->lineEditSlaveAddress->setValue(dd.DeviceId);
     ui->lineEditLength->setValue(dd.Length);
     ui->lineEditLogLimit->setValue(dd.LogViewLimit);
+    ui->lineEditHistoryDepth->setValue(dd.HistoryDepth);
 
     ui->buttonBox->setFocus();
 }
@@ -50,6 +52,7 @@ void DialogDisplayDefinition::accept()
     _displayDefinition.Length = ui->lineEditLength->value<int>();
     _displayDefinition.ScanRate = ui->lineEditScanRate->value<int>();
     _displayDefinition.LogViewLimit = ui->lineEditLogLimit->value<int>();
+    _displayDefinition.HistoryDepth = ui->lineEditHistoryDepth->value<int>();
     _displayDefinition.ZeroBasedAddress = (ui->comboBoxAddressBase->currentAddressBase() == AddressBase::Base0);
 
     QFixedSizeDialog::accept();
@@ -1,5 +1,7 @@
 #include <QAction>
 #include <QAbstractEventDispatcher>
+#include "formmodsca.h"
+#include "memorybudget.h"
 #include "dialogwindowsmanager.h"
 #include "ui_dialogwindowsmanager.h"
 
@@ -7,12 +9,14 @@
 /// \brief DialogWindowsManager::DialogWindowsManager
 /// \param actions
 /// \param saveAction
+/// \param simulator
 /// \param parent
 ///
-DialogWindowsManager::DialogWindowsManager(const QList<QAction*>& actions, QAction* saveAction, QWidget *parent) :
+DialogWindowsManager::DialogWindowsManager(const QList<QAction*>& actions, QAction* saveAction, const DataSimulator* simulator, QWidget *parent) :
       QDialog(parent)
     , ui(new Ui::DialogWindowsManager)
     ,_saveAction(saveAction)
+    ,_dataSimulator(simulator)
     ,_windowActions(actions)
 {
     ui->setupUi(this);
@@ -30,11 +34,16 @@ DialogWindowsManager::DialogWindowsManager(const QList<QAction*>& actions, QActi
         item->setData(Qt::UserRole, QVariant::fromValue(a));
         ui->listWidget->addItem(item);
 
+        const auto frm = qobject_cast<FormModSca*>(wnd->widget());
+        if(frm) item->setText(QString("%1 (%2)").arg(wnd->windowTitle(), QLocale().formattedDataSize(frm->memoryUsage())));
+
         if(wnd->property("isActive").toBool())
             ui->listWidget->setCurrentItem(item);
 
     }
 
+    updateMemoryUsage();
+
     connect(QAbstractEventDispatcher::instance(), &QAbstractEventDispatcher::awake, this, [this]
     {
         const auto item = ui->listWidget->currentItem();
@@ -64,6 +73,24 @@ void DialogWindowsManager::activateWindow(QListWidgetItem *item)
     if(action) action->trigger();
 }
 
+///
+/// \brief DialogWindowsManager::updateMemoryUsage
+///
+void DialogWindowsManager::updateMemoryUsage()
+{
+    const QLocale locale;
+    const auto& budget = MemoryBudget::instance();
+
+    auto text = budget.budget() > 0 ?
+                tr("Logs: %1 of %2").arg(locale.formattedDataSize(budget.used()), locale.formattedDataSize(budget.budget())) :
+                tr("Logs: %1").arg(locale.formattedDataSize(budget.used()));
+
+    if(_dataSimulator)
+        text += "\n" + tr("Simulations: %1").arg(locale.formattedDataSize(_dataSimulator->memoryUsage()));
+
+    ui->labelMemory->setText(text);
+}
+
 ///
 /// \brief DialogWindowsManager::on_listWidget_itemDoubleClicked
 ///
@@ -109,4 +136,6 @@ void DialogWindowsManager::on_pushButtonClose_clicked()
 
     wnd->close();
     delete item;
+
+    updateMemoryUsage();
 }
@@ -4,6 +4,7 @@
 #include <QDialog>
 #include <QMdiSubWindow>
 #include <QListWidgetItem>
+#include "datasimulator.h"
 
 namespace Ui {
 class DialogWindowsManager;
@@ -17,7 +18,7 @@ class DialogWindowsManager : public QDialog
     Q_OBJECT
 
 public:
-    explicit DialogWindowsManager(const QList<QAction*>& actions, QAction* saveAction, QWidget *parent = nullptr);
+    explicit DialogWindowsManager(const QList<QAction*>& actions, QAction* saveAction, const DataSimulator* simulator, QWidget *parent = nullptr);
     ~DialogWindowsManager();
 
 private slots:
@@ -28,12 +29,14 @@ private slots:
 
 private:
     void activateWindow(QListWidgetItem *item);
+    void updateMemoryUsage();
 
 private:
     Ui::DialogWindowsManager *ui;
 
 private:
     QAction* _saveAction;
+    const DataSimulator* _dataSimulator;
     QList<QAction*> _windowActions;
 };
 
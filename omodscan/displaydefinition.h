@@ -17,6 +17,7 @@ struct DisplayDefinition
     quint16 Length = 50;
     quint16 LogViewLimit = 30;
     bool ZeroBasedAddress = false;
+    quint16 HistoryDepth = 0;
 
     void normalize()
     {
@@ -26,6 +27,7 @@ struct DisplayDefinition
         PointType = qBound(QModbusDataUnit::DiscreteInputs, PointType, QModbusDataUnit::HoldingRegisters);
         Length = qBound<quint16>(ModbusLimits::lengthRange().from(), Length, ModbusLimits::lengthRange().to());
         LogViewLimit = qBound<quint16>(4, LogViewLimit, 1000);
+        HistoryDepth = qMin<quint16>(HistoryDepth, 4096);
     }
 };
 Q_DECLARE_METATYPE(DisplayDefinition)
@@ -39,6 +41,7 @@ inline QSettings& operator <<(QSettings& out, const DisplayDefinition& dd)
     out.setValue("DisplayDefinition/Length",            dd.Length);
     out.setValue("DisplayDefinition/LogViewLimit",      dd.LogViewLimit);
     out.setValue("DisplayDefinition/ZeroBasedAddress",  dd.ZeroBasedAddress);
+    out.setValue("DisplayDefinition/HistoryDepth",      dd.HistoryDepth);
 
     return out;
 }
@@ -58,6 +61,7 @@ inline QSettings& operator >>(QSettings& in, DisplayDefinition& dd)
     dd.Length = in.value("DisplayDefinition/Length", 50).toUInt();
     dd.LogViewLimit = in.value("DisplayDefinition/LogViewLimit", 30).toUInt();
     dd.ZeroBasedAddress = in.value("DisplayDefinition/ZeroBasedAddress").toBool();
+    dd.HistoryDepth = in.value("DisplayDefinition/HistoryDepth", 0).toUInt();
 
     dd.normalize();
     return in;
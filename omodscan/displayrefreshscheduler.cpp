@@ -0,0 +1,68 @@
+#include "displayrefreshscheduler.h"
+
+///
+/// \brief DisplayRefreshScheduler::instance
+/// \return
+///
+DisplayRefreshScheduler& DisplayRefreshScheduler::instance()
+{
+    static DisplayRefreshScheduler scheduler;
+    return scheduler;
+}
+
+///
+/// \brief DisplayRefreshScheduler::DisplayRefreshScheduler
+///
+DisplayRefreshScheduler::DisplayRefreshScheduler()
+    : QObject(nullptr)
+    ,_frameRate(30)
+{
+    _timer.setSingleShot(true);
+    _timer.setTimerType(Qt::PreciseTimer);
+    connect(&_timer, &QTimer::timeout, this, &DisplayRefreshScheduler::on_timeout);
+}
+
+///
+/// \brief DisplayRefreshScheduler::setFrameRate
+/// \param fps frames per second up to MaxFrameRate, 0 to refresh the views on every reply
+///
+void DisplayRefreshScheduler::setFrameRate(int fps)
+{
+    _frameRate = qBound(0, fps, MaxFrameRate);
+
+    // nothing may stay pending once frames are off
+    if(!isEnabled() && _timer.isActive())
+    {
+        _timer.stop();
+        on_timeout();
+    }
+}
+
+///
+/// \brief DisplayRefreshScheduler::requestFrame
+/// Schedules the next frame, requests coming before it are merged into it
+///
+void DisplayRefreshScheduler::requestFrame()
+{
+    if(_timer.isActive())
+        return;
+
+    if(!isEnabled())
+    {
+        on_timeout();
+        return;
+    }
+
+    const qint64 interval = 1000 / _frameRate;
+    const qint64 elapsed = _lastFrame.isValid() ? _lastFrame.elapsed() : interval;
+    _timer.start(int(qBound<qint64>(0, interval - elapsed, interval)));
+}
+
+///
+/// \brief DisplayRefreshScheduler::on_timeout
+///
+void DisplayRefreshScheduler::on_timeout()
+{
+    _lastFrame.start();
+    emit frame();
+}
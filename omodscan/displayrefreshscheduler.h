@@ -0,0 +1,50 @@
+#ifndef DISPLAYREFRESHSCHEDULER_H
+#define DISPLAYREFRESHSCHEDULER_H
+
+#include <QTimer>
+#include <QObject>
+#include <QElapsedTimer>
+
+///
+/// \brief The DisplayRefreshScheduler class
+/// Caps how often the views are refreshed. Forms keep the latest data when it
+/// arrives and ask for a frame; one timer shared by all forms then signals the
+/// frame no more often than the frame rate allows.
+///
+class DisplayRefreshScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr int MaxFrameRate = 240;
+
+    static DisplayRefreshScheduler& instance();
+
+    int frameRate() const {
+        return _frameRate;
+    }
+    void setFrameRate(int fps);
+
+    bool isEnabled() const {
+        return _frameRate > 0;
+    }
+
+    void requestFrame();
+
+signals:
+    void frame();
+
+private slots:
+    void on_timeout();
+
+private:
+    DisplayRefreshScheduler();
+    Q_DISABLE_COPY(DisplayRefreshScheduler)
+
+private:
+    int _frameRate;
+    QTimer _timer;
+    QElapsedTimer _lastFrame;
+};
+
+#endif // DISPLAYREFRESHSCHEDULER_H
@@ -0,0 +1,57 @@
+#include "eventloopmonitor.h"
+
+///
+/// \brief EventLoopMonitor::EventLoopMonitor
+/// \param parent
+///
+EventLoopMonitor::EventLoopMonitor(QObject* parent)
+    : QObject(parent)
+{
+    _probe.setTimerType(Qt::PreciseTimer);
+    _probe.setInterval(ProbeInterval);
+    connect(&_probe, &QTimer::timeout, this, &EventLoopMonitor::on_probe);
+}
+
+///
+/// \brief EventLoopMonitor::start
+/// Starts a new window of probes
+///
+void EventLoopMonitor::start()
+{
+    if(_probe.isActive())
+        return;
+
+    _current.reset();
+    _clock.start();
+    _window.start();
+    _probe.start();
+}
+
+///
+/// \brief EventLoopMonitor::stop
+/// Stops the probe, the probes of the unfinished window are dropped
+///
+void EventLoopMonitor::stop()
+{
+    _probe.stop();
+    _current.reset();
+}
+
+///
+/// \brief EventLoopMonitor::on_probe
+///
+void EventLoopMonitor::on_probe()
+{
+    const auto delay = _clock.nsecsElapsed() / 1000 - ProbeInterval * 1000;
+    _current.record(qMax<qint64>(0, delay));
+    _clock.start();
+
+    if(_window.elapsed() >= WindowSize)
+    {
+        _last = _current;
+        _current.reset();
+        _window.start();
+
+        emit updated();
+    }
+}
@@ -0,0 +1,53 @@
+#ifndef EVENTLOOPMONITOR_H
+#define EVENTLOOPMONITOR_H
+
+#include <QTimer>
+#include <QElapsedTimer>
+#include "latencyhistogram.h"
+
+///
+/// \brief The EventLoopMonitor class
+/// Measures GUI event loop responsiveness with a high frequency
+/// precise timer: every probe records how late it was dispatched.
+/// The probe wakes the GUI thread every few milliseconds, so it only
+/// runs between start and stop.
+///
+class EventLoopMonitor : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit EventLoopMonitor(QObject* parent = nullptr);
+
+    void start();
+    void stop();
+
+    bool isActive() const {
+        return _probe.isActive();
+    }
+
+    ///
+    /// \brief histogram of probe delays over the last completed window
+    ///
+    const LatencyHistogram& histogram() const {
+        return _last;
+    }
+
+    static constexpr int ProbeInterval = 5;
+    static constexpr int WindowSize = 5000;
+
+signals:
+    void updated();
+
+private slots:
+    void on_probe();
+
+private:
+    QTimer _probe;
+    QElapsedTimer _clock;
+    QElapsedTimer _window;
+    LatencyHistogram _current;
+    LatencyHistogram _last;
+};
+
+#endif // EVENTLOOPMONITOR_H
@@ -0,0 +1,271 @@
+#ifndef FASTFORMAT_H
+#define FASTFORMAT_H
+
+#include <QChar>
+#include <QLocale>
+#include <QtNumeric>
+
+#if __has_include(<charconv>)
+#include <charconv>
+#endif
+
+///
+/// \brief Size of a buffer that holds any single value written by the functions below
+///
+constexpr int FormatBufferSize = 64;
+
+///
+/// \brief Two-digit decimal lookup table
+///
+constexpr char DigitPairs[] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+///
+/// \brief writeLatin1
+/// \param out
+/// \param s
+/// \return number of characters written
+///
+inline int writeLatin1(QChar* out, const char* s)
+{
+    int n = 0;
+    while(s[n])
+    {
+        out[n] = QLatin1Char(s[n]);
+        n++;
+    }
+    return n;
+}
+
+///
+/// \brief writePadded
+/// Copies the digits right aligned in a field of the given width
+/// \param out
+/// \param digits
+/// \param len
+/// \param width
+/// \param fill
+/// \return number of characters written
+///
+inline int writePadded(QChar* out, const char* digits, int len, int width, char fill)
+{
+    int n = 0;
+    for(; n < width - len; n++)
+        out[n] = QLatin1Char(fill);
+
+    for(int i = 0; i < len; i++)
+        out[n++] = QLatin1Char(digits[i]);
+
+    return n;
+}
+
+///
+/// \brief writeUnsigned
+/// Same as QString("%1").arg(value, width, 10, fill)
+/// \param out
+/// \param value
+/// \param width
+/// \param fill
+/// \return number of characters written
+///
+inline int writeUnsigned(QChar* out, quint64 value, int width = 0, char fill = '0')
+{
+    char tmp[20];
+    char* p = tmp + sizeof(tmp);
+
+    while(value >= 100)
+    {
+        const auto i = (value % 100) * 2;
+        value /= 100;
+        *--p = DigitPairs[i + 1];
+        *--p = DigitPairs[i];
+    }
+
+    if(value >= 10)
+    {
+        const auto i = value * 2;
+        *--p = DigitPairs[i + 1];
+        *--p = DigitPairs[i];
+    }
+    else
+    {
+        *--p = char('0' + value);
+    }
+
+    return writePadded(out, p, int(tmp + sizeof(tmp) - p), width, fill);
+}
+
+///
+/// \brief writeSigned
+/// Same as QString("%1").arg(value, width, 10, fill) for a fill other than '0'
+/// \param out
+/// \param value
+/// \param width
+/// \param fill
+/// \return number of characters written
+///
+inline int writeSigned(QChar* out, qint64 value, int width = 0, char fill = ' ')
+{
+    if(value >= 0)
+        return writeUnsigned(out, quint64(value), width, fill);
+
+    QChar digits[21];
+    digits[0] = QLatin1Char('-');
+    const int len = 1 + writeUnsigned(digits + 1, 0 - quint64(value));
+
+    int n = 0;
+    for(; n < width - len; n++)
+        out[n] = QLatin1Char(fill);
+
+    for(int i = 0; i < len; i++)
+        out[n++] = digits[i];
+
+    return n;
+}
+
+///
+/// \brief writeHex
+/// Same as QString::number(value, 16).toUpper() zero padded to the width
+/// \param out
+/// \param value
+/// \param width
+/// \return number of characters written
+///
+inline int writeHex(QChar* out, quint64 value, int width = 0)
+{
+    char tmp[16];
+    char* p = tmp + sizeof(tmp);
+    do
+    {
+        *--p = "0123456789ABCDEF"[value & 0xF];
+        value >>= 4;
+    }
+    while(value);
+
+    return writePadded(out, p, int(tmp + sizeof(tmp) - p), width, '0');
+}
+
+///
+/// \brief writeBinary
+/// Same as QString::number(value, 2) zero padded to the width
+/// \param out
+/// \param value
+/// \param width
+/// \return number of characters written
+///
+inline int writeBinary(QChar* out, quint64 value, int width = 0)
+{
+    char tmp[64];
+    char* p = tmp + sizeof(tmp);
+    do
+    {
+        *--p = char('0' + (value & 1));
+        value >>= 1;
+    }
+    while(value);
+
+    return writePadded(out, p, int(tmp + sizeof(tmp) - p), width, '0');
+}
+
+///
+/// \brief The NumericLocale struct
+/// What writeReal needs to know about the default locale
+///
+struct NumericLocale
+{
+    QLocale Locale;
+    bool Initialized = false;
+    bool Simple = false;
+    bool Grouping = false;
+    QChar DecimalPoint = QLatin1Char('.');
+};
+
+///
+/// \brief numericLocale
+/// \return the properties of the default locale, refreshed when it changes
+///
+inline const NumericLocale& numericLocale()
+{
+    static thread_local NumericLocale cache;
+
+    const QLocale locale;
+    if(cache.Initialized && cache.Locale == locale)
+        return cache;
+
+    // QChar in Qt 5, QString in Qt 6
+    const QString zeroDigit(locale.zeroDigit());
+    const QString negativeSign(locale.negativeSign());
+    const QString positiveSign(locale.positiveSign());
+    const QString exponential(locale.exponential());
+    const QString decimalPoint(locale.decimalPoint());
+
+    cache.Locale = locale;
+    cache.Initialized = true;
+    cache.Simple = zeroDigit == QLatin1String("0") && negativeSign == QLatin1String("-") &&
+                   positiveSign == QLatin1String("+") && exponential.compare(QLatin1String("e"), Qt::CaseInsensitive) == 0 &&
+                   decimalPoint.size() == 1;
+    cache.Grouping = !(locale.numberOptions() & QLocale::OmitGroupSeparator);
+    cache.DecimalPoint = cache.Simple ? decimalPoint.at(0) : QLatin1Char('.');
+
+    return cache;
+}
+
+///
+/// \brief writeReal
+/// Same as QLocale().toString(value, 'g', precision) for the common locales
+/// \param out
+/// \param value
+/// \param precision
+/// \return number of characters written, -1 when QLocale has to do it
+///
+inline int writeReal(QChar* out, double value, int precision)
+{
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+    if(!qIsFinite(value))
+        return -1;
+
+    const auto& locale = numericLocale();
+    if(!locale.Simple)
+        return -1;
+
+    char buf[FormatBufferSize];
+    const auto res = std::to_chars(buf, buf + sizeof(buf), value, std::chars_format::general, precision);
+    if(res.ec != std::errc())
+        return -1;
+
+    const int len = int(res.ptr - buf);
+
+    int intDigits = 0;
+    bool exponent = false;
+    for(int i = 0; i < len && buf[i] != '.'; i++)
+    {
+        if(buf[i] == 'e') { exponent = true; break; }
+        if(buf[i] != '-') intDigits++;
+    }
+
+    // grouping rules differ between locales, leave them to QLocale
+    if(locale.Grouping && !exponent && intDigits > 3)
+        return -1;
+
+    for(int i = 0; i < len; i++)
+        out[i] = buf[i] == '.' ? locale.DecimalPoint : QLatin1Char(buf[i]);
+
+    return len;
+#else
+    Q_UNUSED(out)
+    Q_UNUSED(value)
+    Q_UNUSED(precision)
+    return -1;
+#endif
+}
+
+#endif // FASTFORMAT_H
@@ -0,0 +1,233 @@
+#include <array>
+#include <utility>
+#include "formatutils.h"
+#include "formatpipeline.h"
+
+///
+/// \brief The PipelineTraits struct
+/// What a display mode decodes to and how it is formatted
+///
+template<typename T, QString (*Format)(T), int StepCount, bool WordSwapped>
+struct PipelineTraits
+{
+    typedef T Type;
+    static constexpr int Step = StepCount;
+    static constexpr bool Swapped = WordSwapped;
+
+    static QString format(T value) {
+        return Format(value);
+    }
+};
+
+///
+/// \brief The ModeTraits struct
+///
+template<DataDisplayMode Mode> struct ModeTraits;
+template<> struct ModeTraits<DataDisplayMode::Binary> : PipelineTraits<quint16, formatBinaryRegister, 1, false> {};
+template<> struct ModeTraits<DataDisplayMode::UInt16> : PipelineTraits<quint16, formatUInt16Register, 1, false> {};
+template<> struct ModeTraits<DataDisplayMode::Int16> : PipelineTraits<qint16, formatInt16Register, 1, false> {};
+template<> struct ModeTraits<DataDisplayMode::Hex> : PipelineTraits<quint16, formatHexRegister, 1, false> {};
+template<> struct ModeTraits<DataDisplayMode::FloatingPt> : PipelineTraits<float, formatFloatRegister, 2, false> {};
+template<> struct ModeTraits<DataDisplayMode::SwappedFP> : PipelineTraits<float, formatFloatRegister, 2, true> {};
+template<> struct ModeTraits<DataDisplayMode::DblFloat> : PipelineTraits<double, formatDoubleRegister, 4, false> {};
+template<> struct ModeTraits<DataDisplayMode::SwappedDbl> : PipelineTraits<double, formatDoubleRegister, 4, true> {};
+template<> struct ModeTraits<DataDisplayMode::Int32> : PipelineTraits<qint32, formatInt32Register, 2, false> {};
+template<> struct ModeTraits<DataDisplayMode::SwappedInt32> : PipelineTraits<qint32, formatInt32Register, 2, true> {};
+template<> struct ModeTraits<DataDisplayMode::UInt32> : PipelineTraits<quint32, formatUInt32Register, 2, false> {};
+template<> struct ModeTraits<DataDisplayMode::SwappedUInt32> : PipelineTraits<quint32, formatUInt32Register, 2, true> {};
+template<> struct ModeTraits<DataDisplayMode::Int64> : PipelineTraits<qint64, formatInt64Register, 4, false> {};
+template<> struct ModeTraits<DataDisplayMode::SwappedInt64> : PipelineTraits<qint64, formatInt64Register, 4, true> {};
+template<> struct ModeTraits<DataDisplayMode::UInt64> : PipelineTraits<quint64, formatUInt64Register, 4, false> {};
+template<> struct ModeTraits<DataDisplayMode::SwappedUInt64> : PipelineTraits<quint64, formatUInt64Register, 4, true> {};
+
+///
+/// \brief formatRegisterPoint
+/// Takes the value from the decoded registers, only the first word of a value gets a string
+///
+template<DataDisplayMode Mode>
+static QString formatRegisterPoint(const QModbusDataUnit&, const DecodedRegisters& decoded, int i, int count, QVariant& outValue)
+{
+    typedef ModeTraits<Mode> Traits;
+
+    const int idx = i / Traits::Step;
+    if((i % Traits::Step) || (i + Traits::Step > count) || idx >= decoded.count())
+        return QString();
+
+    const auto value = decoded.at<typename Traits::Type>(idx);
+    outValue = value;
+    return Traits::format(value);
+}
+
+///
+/// \brief pointValue
+/// \return the word of point i, 0 past the end as QModbusDataUnit::value gives
+///
+static inline quint16 pointValue(const QModbusDataUnit& data, int i)
+{
+    return data.value(i);
+}
+
+///
+/// \brief pointValue
+/// \return the bit of point i as a word, 0 past the end
+///
+static inline quint16 pointValue(const PackedBits& bits, int i)
+{
+    return (i >= 0 && i < bits.size()) ? bits.testBit(i) : 0;
+}
+
+///
+/// \brief formatCoil
+/// Coils and discrete inputs show the word itself, as formatValue does
+///
+template<DataDisplayMode Mode, ByteOrder Order, typename Points>
+static QString formatCoil(const Points& points, int i, QVariant& outValue)
+{
+    typedef ModeTraits<Mode> Traits;
+
+    if constexpr(Traits::Step == 1)
+    {
+        const auto value = typename Traits::Type(toByteOrderValue(pointValue(points, i), Order));
+        outValue = value;
+        return formatBracketed([value](QChar* out) { return writeSigned(out, value); });
+    }
+    else
+    {
+        const quint16 value = pointValue(points, Traits::Swapped ? i + Traits::Step - 1 : i);
+        outValue = value;
+        return formatBracketed([value](QChar* out) { return writeUnsigned(out, value); });
+    }
+}
+
+///
+/// \brief formatCoilPoint
+///
+template<DataDisplayMode Mode, ByteOrder Order>
+static QString formatCoilPoint(const QModbusDataUnit& data, const DecodedRegisters&, int i, int, QVariant& outValue)
+{
+    return formatCoil<Mode, Order>(data, i, outValue);
+}
+
+///
+/// \brief formatBitPoint
+///
+template<DataDisplayMode Mode, ByteOrder Order>
+static QString formatBitPoint(const PackedBits& bits, int i, QVariant& outValue)
+{
+    return formatCoil<Mode, Order>(bits, i, outValue);
+}
+
+///
+/// \brief emptyPoint
+/// Point types without values
+///
+static QString emptyPoint(const QModbusDataUnit&, const DecodedRegisters&, int, int, QVariant&)
+{
+    return QString();
+}
+
+///
+/// \brief emptyBit
+///
+static QString emptyBit(const PackedBits&, int, QVariant&)
+{
+    return QString();
+}
+
+///
+/// \brief ModeCount
+///
+static constexpr int ModeCount = int(DataDisplayMode::SwappedUInt64) + 1;
+
+///
+/// \brief PipelineTable
+/// One pipeline per display mode
+///
+typedef std::array<FormatPipeline, ModeCount> PipelineTable;
+
+///
+/// \brief registerPipelines
+///
+template<int... Modes>
+static constexpr PipelineTable registerPipelines(std::integer_sequence<int, Modes...>)
+{
+    return {{ &formatRegisterPoint<DataDisplayMode(Modes)>... }};
+}
+
+///
+/// \brief coilPipelines
+///
+template<ByteOrder Order, int... Modes>
+static constexpr PipelineTable coilPipelines(std::integer_sequence<int, Modes...>)
+{
+    return {{ &formatCoilPoint<DataDisplayMode(Modes), Order>... }};
+}
+
+///
+/// \brief BitPipelineTable
+///
+typedef std::array<BitPipeline, ModeCount> BitPipelineTable;
+
+///
+/// \brief bitPipelines
+///
+template<ByteOrder Order, int... Modes>
+static constexpr BitPipelineTable bitPipelines(std::integer_sequence<int, Modes...>)
+{
+    return {{ &formatBitPoint<DataDisplayMode(Modes), Order>... }};
+}
+
+///
+/// \brief formatPipeline
+/// Picks the pipeline for a view, meant to be called once per update and not per point.
+/// The byte order of registers is applied by the decoder, coils apply it themselves.
+/// \param pointType
+/// \param mode
+/// \param order
+/// \return
+///
+FormatPipeline formatPipeline(QModbusDataUnit::RegisterType pointType, DataDisplayMode mode, ByteOrder order)
+{
+    static constexpr auto modes = std::make_integer_sequence<int, ModeCount>();
+    static constexpr PipelineTable registers = registerPipelines(modes);
+    static constexpr PipelineTable coilsLittleEndian = coilPipelines<ByteOrder::LittleEndian>(modes);
+    static constexpr PipelineTable coilsBigEndian = coilPipelines<ByteOrder::BigEndian>(modes);
+
+    const int idx = int(mode);
+    if(idx < 0 || idx >= ModeCount)
+        return emptyPoint;
+
+    switch(pointType)
+    {
+        case QModbusDataUnit::HoldingRegisters:
+        case QModbusDataUnit::InputRegisters:
+            return registers[idx];
+
+        case QModbusDataUnit::Coils:
+        case QModbusDataUnit::DiscreteInputs:
+            return (order == ByteOrder::BigEndian) ? coilsBigEndian[idx] : coilsLittleEndian[idx];
+
+        default:
+            return emptyPoint;
+    }
+}
+
+///
+/// \brief bitPipeline
+/// Picks the pipeline for a view of packed coils or discrete inputs
+/// \param mode
+/// \param order
+/// \return
+///
+BitPipeline bitPipeline(DataDisplayMode mode, ByteOrder order)
+{
+    static constexpr auto modes = std::make_integer_sequence<int, ModeCount>();
+    static constexpr BitPipelineTable bitsLittleEndian = bitPipelines<ByteOrder::LittleEndian>(modes);
+    static constexpr BitPipelineTable bitsBigEndian = bitPipelines<ByteOrder::BigEndian>(modes);
+
+    const int idx = int(mode);
+    if(idx < 0 || idx >= ModeCount)
+        return emptyBit;
+
+    return (order == ByteOrder::BigEndian) ? bitsBigEndian[idx] : bitsLittleEndian[idx];
+}
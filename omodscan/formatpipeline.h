@@ -0,0 +1,29 @@
+#ifndef FORMATPIPELINE_H
+#define FORMATPIPELINE_H
+
+#include <QString>
+#include <QVariant>
+#include <QModbusDataUnit>
+#include "enums.h"
+#include "packedbits.h"
+#include "registerdecoder.h"
+
+///
+/// \brief FormatPipeline
+/// Formats point i of a data unit like formatValue does, specialized for one
+/// display mode, point type and byte order. The decoded registers must have
+/// been decoded for the same mode and byte order.
+///
+typedef QString (*FormatPipeline)(const QModbusDataUnit& data, const DecodedRegisters& decoded, int i, int count, QVariant& outValue);
+
+FormatPipeline formatPipeline(QModbusDataUnit::RegisterType pointType, DataDisplayMode mode, ByteOrder order);
+
+///
+/// \brief BitPipeline
+/// Formats point i of packed coils or discrete inputs like the coil pipelines do
+///
+typedef QString (*BitPipeline)(const PackedBits& bits, int i, QVariant& outValue);
+
+BitPipeline bitPipeline(DataDisplayMode mode, ByteOrder order);
+
+#endif // FORMATPIPELINE_H
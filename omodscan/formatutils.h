@@ -6,6 +6,7 @@
 #include <QModbusPdu>
 #include <QModbusDataUnit>
 #include "enums.h"
+#include "fastformat.h"
 #include "numericutils.h"
 #include "byteorderutils.h"
 
@@ -18,15 +19,23 @@
 ///
 inline QString formatUInt8Value(DataDisplayMode mode, quint8 c)
 {
+    QChar buf[FormatBufferSize];
+    int n = 0;
+
     switch(mode)
     {
     case DataDisplayMode::UInt16:
         case DataDisplayMode::Int16:
-            return QString("%1").arg(QString::number(c), 3, '0');
+            n = writeUnsigned(buf, c, 3);
+        break;
 
         default:
-            return QString("0x%1").arg(QString::number(c, 16).toUpper(), 2, '0');
+            n = writeLatin1(buf, "0x");
+            n += writeHex(buf + n, c, 2);
+        break;
     }
+
+    return QString(buf, n);
 }
 
 ///
@@ -37,21 +46,31 @@ inline QString formatUInt8Value(DataDisplayMode mode, quint8 c)
 ///
 inline QString formatUInt8Array(DataDisplayMode mode, const QByteArray& ar)
 {
-    QStringList values;
+    QString result;
+    result.reserve(ar.size() * 4);
+
+    QChar buf[FormatBufferSize];
     for(quint8 i : ar)
+    {
+        int n = 0;
+        if(!result.isEmpty())
+            buf[n++] = QLatin1Char(' ');
+
         switch(mode)
         {
         case DataDisplayMode::UInt16:
             case DataDisplayMode::Int16:
-                values += QString("%1").arg(QString::number(i), 3, '0');
+                n += writeUnsigned(buf + n, i, 3);
             break;
 
             default:
-                values += QString("%1").arg(QString::number(i, 16).toUpper(), 2, '0');
+                n += writeHex(buf + n, i, 2);
             break;
         }
+        result.append(buf, n);
+    }
 
-    return values.join(" ");
+    return result;
 }
 
 ///
@@ -63,24 +82,34 @@ inline QString formatUInt8Array(DataDisplayMode mode, const QByteArray& ar)
 ///
 inline QString formatUInt16Array(DataDisplayMode mode, const QByteArray& ar, ByteOrder order)
 {
-    QStringList values;
+    QString result;
+    result.reserve(ar.size() / 2 * 7);
+
+    QChar buf[FormatBufferSize];
     for(int i = 0; i < ar.size(); i+=2)
     {
         const quint16 value = makeUInt16(ar[i+1], ar[i], order);
+
+        int n = 0;
+        if(!result.isEmpty())
+            buf[n++] = QLatin1Char(' ');
+
         switch(mode)
         {
         case DataDisplayMode::UInt16:
             case DataDisplayMode::Int16:
-                values += QString("%1").arg(QString::number(value), 5, '0');
+                n += writeUnsigned(buf + n, value, 5);
                 break;
 
             default:
-                values += QString("0x%1").arg(QString::number(value, 16).toUpper(), 4, '0');
+                n += writeLatin1(buf + n, "0x");
+                n += writeHex(buf + n, value, 4);
                 break;
         }
+        result.append(buf, n);
     }
 
-    return values.join(" ");
+    return result;
 }
 
 ///
@@ -91,15 +120,146 @@ inline QString formatUInt16Array(DataDisplayMode mode, const QByteArray& ar, Byt
 ///
 inline QString formatUInt16Value(DataDisplayMode mode, quint16 v)
 {
+    QChar buf[FormatBufferSize];
+    int n = 0;
+
     switch(mode)
     {
     case DataDisplayMode::UInt16:
         case DataDisplayMode::Int16:
-            return QString("%1").arg(QString::number(v), 5, '0');
+            n = writeUnsigned(buf, v, 5);
+        break;
 
         default:
-            return QString("0x%1").arg(QString::number(v, 16).toUpper(), 4, '0');
+            n = writeLatin1(buf, "0x");
+            n += writeHex(buf + n, v, 4);
+        break;
     }
+
+    return QString(buf, n);
+}
+
+///
+/// \brief formatBracketed
+/// Builds "<value>" around a value written by one of the fastformat.h functions
+/// \param write
+/// \return
+///
+template<typename Writer>
+inline QString formatBracketed(Writer write)
+{
+    QChar buf[FormatBufferSize];
+    buf[0] = QLatin1Char('<');
+    int n = 1 + write(buf + 1);
+    buf[n++] = QLatin1Char('>');
+    return QString(buf, n);
+}
+
+///
+/// \brief formatBinaryRegister
+/// \param value
+/// \return
+///
+inline QString formatBinaryRegister(quint16 value)
+{
+    return formatBracketed([value](QChar* out) { return writeBinary(out, value, 16); });
+}
+
+///
+/// \brief formatUInt16Register
+/// \param value
+/// \return
+///
+inline QString formatUInt16Register(quint16 value)
+{
+    return formatBracketed([value](QChar* out) { return writeUnsigned(out, value, 5); });
+}
+
+///
+/// \brief formatInt16Register
+/// \param value
+/// \return
+///
+inline QString formatInt16Register(qint16 value)
+{
+    return formatBracketed([value](QChar* out) { return writeSigned(out, value, 5); });
+}
+
+///
+/// \brief formatHexRegister
+/// \param value
+/// \return
+///
+inline QString formatHexRegister(quint16 value)
+{
+    return formatBracketed([value](QChar* out) {
+        const int n = writeLatin1(out, "0x");
+        return n + writeHex(out + n, value, 4);
+    });
+}
+
+///
+/// \brief formatFloatRegister
+/// \param value
+/// \return
+///
+inline QString formatFloatRegister(float value)
+{
+    QChar buf[FormatBufferSize];
+    const int n = writeReal(buf, value, 6);
+    return (n >= 0) ? QString(buf, n) : QLocale().toString(value);
+}
+
+///
+/// \brief formatDoubleRegister
+/// \param value
+/// \return
+///
+inline QString formatDoubleRegister(double value)
+{
+    QChar buf[FormatBufferSize];
+    const int n = writeReal(buf, value, 16);
+    return (n >= 0) ? QString(buf, n) : QLocale().toString(value, 'g', 16);
+}
+
+///
+/// \brief formatInt32Register
+/// \param value
+/// \return
+///
+inline QString formatInt32Register(qint32 value)
+{
+    return formatBracketed([value](QChar* out) { return writeSigned(out, value, 10); });
+}
+
+///
+/// \brief formatUInt32Register
+/// \param value
+/// \return
+///
+inline QString formatUInt32Register(quint32 value)
+{
+    return formatBracketed([value](QChar* out) { return writeUnsigned(out, value, 10); });
+}
+
+///
+/// \brief formatInt64Register
+/// \param value
+/// \return
+///
+inline QString formatInt64Register(qint64 value)
+{
+    return formatBracketed([value](QChar* out) { return writeSigned(out, value, 20); });
+}
+
+///
+/// \brief formatUInt64Register
+/// \param value
+/// \return
+///
+inline QString formatUInt64Register(quint64 value)
+{
+    return formatBracketed([value](QChar* out) { return writeUnsigned(out, value, 20); });
 }
 
 ///
@@ -118,11 +278,11 @@ inline QString formatBinaryValue(QModbusDataUnit::RegisterType pointType, quint1
     {
         case QModbusDataUnit::Coils:
         case QModbusDataUnit::DiscreteInputs:
-            result = QString("<%1>").arg(value);
+            result = formatBracketed([value](QChar* out) { return writeUnsigned(out, value); });
             break;
         case QModbusDataUnit::HoldingRegisters:
         case QModbusDataUnit::InputRegisters:
-            result = QStringLiteral("<%1>").arg(value, 16, 2, QLatin1Char('0'));
+            result = formatBinaryRegister(value);
             break;
         default:
             break;
@@ -147,11 +307,11 @@ inline QString formatUInt16Value(QModbusDataUnit::RegisterType pointType, quint1
     {
         case QModbusDataUnit::Coils:
         case QModbusDataUnit::DiscreteInputs:
-            result = QStringLiteral("<%1>").arg(value, 1, 10, QLatin1Char('0'));
+            result = formatBracketed([value](QChar* out) { return writeUnsigned(out, value); });
             break;
         case QModbusDataUnit::HoldingRegisters:
         case QModbusDataUnit::InputRegisters:
-            result = QStringLiteral("<%1>").arg(value, 5, 10, QLatin1Char('0'));
+            result = formatUInt16Register(value);
             break;
         default:
             break;
@@ -176,11 +336,11 @@ inline QString formatInt16Value(QModbusDataUnit::RegisterType pointType, qint16
     {
         case QModbusDataUnit::Coils:
         case QModbusDataUnit::DiscreteInputs:
-            result = QString("<%1>").arg(value);
+            result = formatBracketed([value](QChar* out) { return writeSigned(out, value); });
             break;
         case QModbusDataUnit::HoldingRegisters:
         case QModbusDataUnit::InputRegisters:
-            result = QStringLiteral("<%1>").arg(value, 5, 10, QLatin1Char(' '));
+            result = formatInt16Register(value);
             break;
         default:
             break;
@@ -205,11 +365,11 @@ inline QString formatHexValue(QModbusDataUnit::RegisterType pointType, quint16 v
     {
         case QModbusDataUnit::Coils:
         case QModbusDataUnit::DiscreteInputs:
-            result = QString("<%1>").arg(value);
+            result = formatBracketed([value](QChar* out) { return writeUnsigned(out, value); });
             break;
         case QModbusDataUnit::HoldingRegisters:
         case QModbusDataUnit::InputRegisters:
-            result = QString("<0x%1>").arg(QString::number(value, 16).toUpper(), 4, '0');
+            result = formatHexRegister(value);
             break;
         default:
             break;
@@ -236,7 +396,7 @@ inline QString formatFloatValue(QModbusDataUnit::RegisterType pointType, quint16
         case QModbusDataUnit::Coils:
         case QModbusDataUnit::DiscreteInputs:
             outValue = value1;
-            result = QString("<%1>").arg(value1);
+            result = formatBracketed([value1](QChar* out) { return writeUnsigned(out, value1); });
             break;
         case QModbusDataUnit::HoldingRegisters:
         case QModbusDataUnit::InputRegisters:
@@ -245,7 +405,7 @@ inline QString formatFloatValue(QModbusDataUnit::RegisterType pointType, quint16
 
             const float value = makeFloat(value1, value2, order);
             outValue = value;
-            result = QLocale().toString(value);
+            result = formatFloatRegister(value);
         }
         break;
         default:
@@ -272,7 +432,7 @@ inline QString formatInt32Value(QModbusDataUnit::RegisterType pointType, quint16
         case QModbusDataUnit::Coils:
         case QModbusDataUnit::DiscreteInputs:
             outValue = value1;
-            result = QString("<%1>").arg(value1);
+            result = formatBracketed([value1](QChar* out) { return writeUnsigned(out, value1); });
             break;
         case QModbusDataUnit::HoldingRegisters:
         case QModbusDataUnit::InputRegisters:
@@ -281,7 +441,7 @@ inline QString formatInt32Value(QModbusDataUnit::RegisterType pointType, quint16
 
             const qint32 value = makeInt32(value1, value2, order);
             outValue = value;
-            result = QString("<%1>").arg(value, 10, 10, QLatin1Char(' '));
+            result = formatInt32Register(value);
         }
         break;
         default:
@@ -308,7 +468,7 @@ inline QString formatUInt32Value(QModbusDataUnit::RegisterType pointType, quint1
         case QModbusDataUnit::Coils:
         case QModbusDataUnit::DiscreteInputs:
             outValue = value1;
-            result = QString("<%1>").arg(value1);
+            result = formatBracketed([value1](QChar* out) { return writeUnsigned(out, value1); });
             break;
         case QModbusDataUnit::HoldingRegisters:
         case QModbusDataUnit::InputRegisters:
@@ -317,7 +477,7 @@ inline QString formatUInt32Value(QModbusDataUnit::RegisterType pointType, quint1
 
             const quint32 value = makeUInt32(value1, value2, order);
             outValue = value;
-            result = QString("<%1>").arg(value, 10, 10, QLatin1Char('0'));
+            result = formatUInt32Register(value);
         }
         break;
         default:
@@ -346,7 +506,7 @@ inline QString formatDoubleValue(QModbusDataUnit::RegisterType pointType, quint1
         case QModbusDataUnit::Coils:
         case QModbusDataUnit::DiscreteInputs:
             outValue = value1;
-            result = QString("<%1>").arg(value1);
+            result = formatBracketed([value1](QChar* out) { return writeUnsigned(out, value1); });
             break;
         case QModbusDataUnit::HoldingRegisters:
         case QModbusDataUnit::InputRegisters:
@@ -355,7 +515,7 @@ inline QString formatDoubleValue(QModbusDataUnit::RegisterType pointType, quint1
 
             const double value = makeDouble(value1, value2, value3, value4, order);
             outValue = value;
-            result = QLocale().toString(value, 'g', 16);
+            result = formatDoubleRegister(value);
         }
         break;
         default:
@@ -384,7 +544,7 @@ inline QString formatInt64Value(QModbusDataUnit::RegisterType pointType, quint16
         case QModbusDataUnit::Coils:
         case QModbusDataUnit::DiscreteInputs:
             outValue = value1;
-            result = QString("<%1>").arg(value1);
+            result = formatBracketed([value1](QChar* out) { return writeUnsigned(out, value1); });
             break;
         case QModbusDataUnit::HoldingRegisters:
         case QModbusDataUnit::InputRegisters:
@@ -393,7 +553,7 @@ inline QString formatInt64Value(QModbusDataUnit::RegisterType pointType, quint16
 
             const qint64 value = makeInt64(value1, value2, value3, value4, order);
             outValue = value;
-            result = QString("<%1>").arg(value, 20, 10, QLatin1Char(' '));
+            result = formatInt64Register(value);
         }
         break;
         default:
@@ -422,7 +582,7 @@ inline QString formatUInt64Value(QModbusDataUnit::RegisterType pointType, quint1
         case QModbusDataUnit::Coils:
         case QModbusDataUnit::DiscreteInputs:
             outValue = value1;
-            result = QString("<%1>").arg(value1);
+            result = formatBracketed([value1](QChar* out) { return writeUnsigned(out, value1); });
             break;
         case QModbusDataUnit::HoldingRegisters:
         case QModbusDataUnit::InputRegisters:
@@ -431,7 +591,7 @@ inline QString formatUInt64Value(QModbusDataUnit::RegisterType pointType, quint1
 
             const quint64 value = makeUInt64(value1, value2, value3, value4, order);
             outValue = value;
-            result = QString("<%1>").arg(value, 20, 10, QLatin1Char('0'));
+            result = formatUInt64Register(value);
         }
         break;
         default:
@@ -440,6 +600,79 @@ inline QString formatUInt64Value(QModbusDataUnit::RegisterType pointType, quint1
     return result;
 }
 
+///
+/// \brief formatValue
+/// Formats the point at the given index of a data unit the way the output view shows it.
+/// Multi-register modes yield an empty string for the trailing words of a value.
+/// \param pointType
+/// \param data
+/// \param i index of the point
+/// \param count number of points in the view
+/// \param mode
+/// \param order
+/// \param outValue
+/// \return
+///
+inline QString formatValue(QModbusDataUnit::RegisterType pointType, const QModbusDataUnit& data, int i, int count, DataDisplayMode mode, ByteOrder order, QVariant& outValue)
+{
+    const auto value = data.value(i);
+    const bool flag32 = (i%2) || (i+1>=count);
+    const bool flag64 = (i%4) || (i+3>=count);
+
+    switch(mode)
+    {
+        case DataDisplayMode::Binary:
+            return formatBinaryValue(pointType, value, order, outValue);
+
+        case DataDisplayMode::UInt16:
+            return formatUInt16Value(pointType, value, order, outValue);
+
+        case DataDisplayMode::Int16:
+            return formatInt16Value(pointType, value, order, outValue);
+
+        case DataDisplayMode::Hex:
+            return formatHexValue(pointType, value, order, outValue);
+
+        case DataDisplayMode::FloatingPt:
+            return formatFloatValue(pointType, value, data.value(i+1), order, flag32, outValue);
+
+        case DataDisplayMode::SwappedFP:
+            return formatFloatValue(pointType, data.value(i+1), value, order, flag32, outValue);
+
+        case DataDisplayMode::DblFloat:
+            return formatDoubleValue(pointType, value, data.value(i+1), data.value(i+2), data.value(i+3), order, flag64, outValue);
+
+        case DataDisplayMode::SwappedDbl:
+            return formatDoubleValue(pointType, data.value(i+3), data.value(i+2), data.value(i+1), value, order, flag64, outValue);
+
+        case DataDisplayMode::Int32:
+            return formatInt32Value(pointType, value, data.value(i+1), order, flag32, outValue);
+
+        case DataDisplayMode::SwappedInt32:
+            return formatInt32Value(pointType, data.value(i+1), value, order, flag32, outValue);
+
+        case DataDisplayMode::UInt32:
+            return formatUInt32Value(pointType, value, data.value(i+1), order, flag32, outValue);
+
+        case DataDisplayMode::SwappedUInt32:
+            return formatUInt32Value(pointType, data.value(i+1), value, order, flag32, outValue);
+
+        case DataDisplayMode::Int64:
+            return formatInt64Value(pointType, value, data.value(i+1), data.value(i+2), data.value(i+3), order, flag64, outValue);
+
+        case DataDisplayMode::SwappedInt64:
+            return formatInt64Value(pointType, data.value(i+3), data.value(i+2), data.value(i+1), value, order, flag64, outValue);
+
+        case DataDisplayMode::UInt64:
+            return formatUInt64Value(pointType, value, data.value(i+1), data.value(i+2), data.value(i+3), order, flag64, outValue);
+
+        case DataDisplayMode::SwappedUInt64:
+            return formatUInt64Value(pointType, data.value(i+3), data.value(i+2), data.value(i+1), value, order, flag64, outValue);
+    }
+
+    return QString();
+}
+
 ///
 /// \brief formatAddress
 /// \param pointType
@@ -449,27 +682,36 @@ inline QString formatUInt64Value(QModbusDataUnit::RegisterType pointType, quint1
 ///
 inline QString formatAddress(QModbusDataUnit::RegisterType pointType, int address, bool hexFormat)
 {
-    QString prefix;
+    QChar buf[FormatBufferSize];
+    int n = 0;
+
+    if(hexFormat)
+    {
+        n = writeLatin1(buf, "0x");
+        n += writeHex(buf + n, quint32(address), 4);
+        return QString(buf, n);
+    }
+
     switch(pointType)
     {
         case QModbusDataUnit::Coils:
-            prefix = "0";
+            buf[n++] = QLatin1Char('0');
             break;
         case QModbusDataUnit::DiscreteInputs:
-            prefix = "1";
+            buf[n++] = QLatin1Char('1');
             break;
         case QModbusDataUnit::HoldingRegisters:
-            prefix = "4";
+            buf[n++] = QLatin1Char('4');
             break;
         case QModbusDataUnit::InputRegisters:
-            prefix = "3";
+            buf[n++] = QLatin1Char('3');
             break;
         default:
             break;
     }
 
-    return hexFormat ? QString("0x%1").arg(QString::number(address, 16).toUpper(), 4, '0') :
-               prefix + QStringLiteral("%1").arg(address, 4, 10, QLatin1Char('0'));
+    n += writeUnsigned(buf + n, quint32(address), 4);
+    return QString(buf, n);
 }
 
 #endif // FORMATUTILS_H
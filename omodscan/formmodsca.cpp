@@ -3,14 +3,15 @@
 #include <QDateTime>
 #include "modbuslimits.h"
 #include "modbusexception.h"
-#include "mainwindow.h"
+#include "requesttracer.h"
+#include "displayrefreshscheduler.h"
 #include "dialogwritecoilregister.h"
 #include "dialogwriteholdingregister.h"
 #include "dialogwriteholdingregisterbits.h"
 #include "formmodsca.h"
 #include "ui_formmodsca.h"
 
-QVersionNumber FormModSca::VERSION = QVersionNumber(1, 5);
+QVersionNumber FormModSca::VERSION = QVersionNumber(1, 7);
 
 ///
 /// \brief FormModSca::FormModSca
@@ -19,15 +20,21 @@ QVersionNumber FormModSca::VERSION = QVersionNumber(1, 5);
 /// \param ver
 /// \param parent
 ///
-FormModSca::FormModSca(int id, ModbusClient& client, DataSimulator* simulator, MainWindow* parent)
+FormModSca::FormModSca(int id, ModbusClient& client, DataSimulator* simulator, QWidget* parent)
     : QWidget(parent)
     , ui(new Ui::FormModSca)
     ,_formId(id)
     ,_validSlaveResponses(0)
     ,_noSlaveResponsesCounter(0)
+    ,_scanDeadline(0)
     ,_modbusClient(client)
     ,_dataSimulator(simulator)
     ,_parent(parent)
+    ,_metrics(nullptr)
+    ,_pollTime(-1)
+    ,_burstActive(false)
+    ,_burstTransactionId(-1)
+    ,_burstRequestTime(0)
 {
     Q_ASSERT(parent != nullptr);
     Q_ASSERT(simulator != nullptr);
@@ -61,6 +68,7 @@ FormModSca::FormModSca(int id, ModbusClient& client, DataSimulator* simulator, M
     connect(&_modbusClient, &ModbusClient::modbusConnected, this, &FormModSca::on_modbusConnected);
     connect(&_modbusClient, &ModbusClient::modbusDisconnected, this, &FormModSca::on_modbusDisconnected);
     connect(&_timer, &QTimer::timeout, this, &FormModSca::on_timeout);
+    connect(&DisplayRefreshScheduler::instance(), &DisplayRefreshScheduler::frame, this, &FormModSca::on_displayFrame);
 
     connect(_dataSimulator, &DataSimulator::simulationStarted, this, &FormModSca::on_simulationStarted);
     connect(_dataSimulator, &DataSimulator::simulationStopped, this, &FormModSca::on_simulationStopped);
@@ -72,6 +80,7 @@ FormModSca::FormModSca(int id, ModbusClient& client, DataSimulator* simulator, M
 ///
 FormModSca::~FormModSca()
 {
+    finishTransactions();
     delete ui;
 }
 
@@ -130,6 +139,7 @@ DisplayDefinition FormModSca::displayDefinition() const
     dd.Length = ui->lineEditLength->value<int>();
     dd.LogViewLimit = ui->outputWidget->logViewLimit();
     dd.ZeroBasedAddress = ui->lineEditAddress->range<int>().from() == 0;
+    dd.HistoryDepth = ui->outputWidget->historyDepth();
 
     return dd;
 }
@@ -141,6 +151,7 @@ DisplayDefinition FormModSca::displayDefinition() const
 void FormModSca::setDisplayDefinition(const DisplayDefinition& dd)
 {
     _timer.setInterval(dd.ScanRate);
+    if(_timer.isActive()) restartScanClock();
 
     ui->lineEditDeviceId->blockSignals(true);
     ui->lineEditDeviceId->setValue(dd.DeviceId);
@@ -163,6 +174,7 @@ void FormModSca::setDisplayDefinition(const DisplayDefinition& dd)
     ui->comboBoxModbusPointType->setCurrentPointType(dd.PointType);
     ui->comboBoxModbusPointType->blockSignals(false);
 
+    ui->outputWidget->setHistoryDepth(dd.HistoryDepth);
     ui->outputWidget->setStatus(tr("Data Uninitialized"));
 
     const auto protocol = _modbusClient.connectionType() == ConnectionType::Serial ? ModbusMessage::Rtu : ModbusMessage::Tcp;
@@ -225,6 +237,24 @@ void FormModSca::setDataDisplayMode(DataDisplayMode mode)
     ui->outputWidget->setDataDisplayMode(mode);
 }
 
+///
+/// \brief FormModSca::extraColumns
+/// \return
+///
+QVector<DataDisplayMode> FormModSca::extraColumns() const
+{
+    return ui->outputWidget->extraColumns();
+}
+
+///
+/// \brief FormModSca::setExtraColumns
+/// \param modes
+///
+void FormModSca::setExtraColumns(const QVector<DataDisplayMode>& modes)
+{
+    ui->outputWidget->setExtraColumns(modes);
+}
+
 ///
 /// \brief FormModSca::byteOrder
 /// \return
@@ -394,7 +424,11 @@ void FormModSca::print(QPrinter* printer)
     auto rcOutput = pageRect;
     rcOutput.setTop(rcAddrLen.bottom() + 20);
 
-    ui->outputWidget->paint(rcOutput, painter);
+    // the rows go on over as many pages as they need, all in the same grid
+    int row = 0;
+    const int cellWidth = ui->outputWidget->printCellWidth(painter.fontMetrics());
+    while(ui->outputWidget->paint(rcOutput, painter, row, cellWidth) && printer->newPage())
+        rcOutput = pageRect;
 }
 
 ///
@@ -443,6 +477,15 @@ AddressDescriptionMap FormModSca::descriptionMap() const
     return ui->outputWidget->descriptionMap();
 }
 
+///
+/// \brief FormModSca::memoryUsage
+/// \return approximate number of bytes held by the data and the traffic log
+///
+qint64 FormModSca::memoryUsage() const
+{
+    return ui->outputWidget->memoryUsage();
+}
+
 ///
 /// \brief FormModSca::setDescription
 /// \param type
@@ -480,6 +523,61 @@ uint FormModSca::validSlaveResposes() const
     return ui->statisticWidget->validSlaveResposes();
 }
 
+///
+/// \brief FormModSca::startBurstPolling
+/// \param params
+/// \return why the burst did not start, NoError if it is running
+///
+BurstPollingError FormModSca::startBurstPolling(const BurstPollingParams& params)
+{
+    if(_burstActive)
+        return BurstPollingError::AlreadyActive;
+
+    if(_modbusClient.state() != QModbusDevice::ConnectedState)
+        return BurstPollingError::NotConnected;
+
+    const auto dd = displayDefinition();
+    const auto addr = dd.PointAddress - (dd.ZeroBasedAddress ?  0 : 1);
+    if(addr + dd.Length > ModbusLimits::addressRange(dd.ZeroBasedAddress).to())
+        return BurstPollingError::InvalidRange;
+
+    _burstParams = params;
+    _burstParams.normalize();
+
+    _burstResult = BurstPollingResult();
+    if(_burstParams.Mode == BurstPollingMode::Samples)
+        _burstResult.Samples.reserve(_burstParams.Samples);
+
+    _burstActive = true;
+    _timer.stop();
+    _scanClock.invalidate();
+    _burstClock.start();
+
+    // replies come asynchronously, a burst that stopped already never got its request out
+    sendBurstRequest();
+    return _burstActive ? BurstPollingError::NoError : BurstPollingError::RequestFailed;
+}
+
+///
+/// \brief FormModSca::stopBurstPolling
+///
+void FormModSca::stopBurstPolling()
+{
+    if(!_burstActive)
+        return;
+
+    _burstActive = false;
+    _burstTransactionId = -1;
+
+    if(_modbusClient.state() == QModbusDevice::ConnectedState)
+    {
+        _timer.start();
+        restartScanClock();
+    }
+
+    emit burstPollingFinished(_burstResult);
+}
+
 ///
 /// \brief FormModSca::show
 ///
@@ -494,7 +592,20 @@ void FormModSca::show()
 ///
 void FormModSca::on_timeout()
 {
-    if(_modbusClient.state() != QModbusDevice::ConnectedState)
+    // lateness is measured against the deadline the timer was scheduled for, so one
+    // late tick does not make the next one look early. Ticks missed by then are
+    // skipped as QTimer skips them.
+    if(_scanClock.isValid())
+    {
+        const auto now = _scanClock.nsecsElapsed();
+        const auto interval = qint64(_timer.interval()) * 1000000;
+        ui->statisticWidget->addTimerLateness((now - _scanDeadline) / 1000);
+
+        _scanDeadline += interval;
+        if(_scanDeadline < now) _scanDeadline = now + interval;
+    }
+
+    if(_burstActive || _modbusClient.state() != QModbusDevice::ConnectedState)
         return;
 
     const auto dd = displayDefinition();
@@ -510,7 +621,9 @@ void FormModSca::on_timeout()
             }
         }
 
+        _pollTime = RequestTracer::instance().now();
         _modbusClient.sendReadRequest(dd.PointType, addr, dd.Length, dd.DeviceId, _formId);
+        _pollTime = -1;
     }
 }
 
@@ -530,6 +643,71 @@ void FormModSca::beginUpdate()
         ui->outputWidget->setStatus(tr("No Scan: Invalid Data Length Specified"));
 
     _timer.start();
+    restartScanClock();
+}
+
+///
+/// \brief FormModSca::restartScanClock
+/// Called whenever the scan timer is (re)started, the first tick is due one interval later
+///
+void FormModSca::restartScanClock()
+{
+    _scanClock.start();
+    _scanDeadline = qint64(_timer.interval()) * 1000000;
+}
+
+///
+/// \brief FormModSca::sendBurstRequest
+///
+void FormModSca::sendBurstRequest()
+{
+    const auto dd = displayDefinition();
+    const auto addr = dd.PointAddress - (dd.ZeroBasedAddress ?  0 : 1);
+    if(addr + dd.Length > ModbusLimits::addressRange(dd.ZeroBasedAddress).to())
+    {
+        ui->outputWidget->setStatus(tr("No Scan: Invalid Data Length Specified"));
+        stopBurstPolling();
+        return;
+    }
+
+    _burstTransactionId = -1;
+    _burstRequestTime = _burstClock.nsecsElapsed();
+
+    // without a reply to wait for the burst could never go on,
+    // the transaction id is assigned in on_modbusRequest
+    if(!_modbusClient.sendReadRequest(dd.PointType, addr, dd.Length, dd.DeviceId, _formId) ||
+       _burstTransactionId == -1)
+    {
+        stopBurstPolling();
+    }
+}
+
+///
+/// \brief FormModSca::updateBurstPolling
+/// \param reply
+/// \param valid
+///
+void FormModSca::updateBurstPolling(const QModbusReply* reply, bool valid)
+{
+    if(!_burstActive || reply->property("TransactionId").toInt() != _burstTransactionId)
+        return;
+
+    BurstSample sample;
+    sample.RequestTime = _burstRequestTime;
+    sample.ResponseTime = _burstClock.nsecsElapsed();
+    sample.Valid = valid;
+    _burstResult.Samples.push_back(sample);
+
+    emit burstPollingProgress(_burstResult.Samples.size());
+
+    const bool finished = (_burstParams.Mode == BurstPollingMode::Samples) ?
+                              (quint32)_burstResult.Samples.size() >= _burstParams.Samples :
+                              _burstClock.elapsed() >= _burstParams.Duration;
+
+    if(finished)
+        stopBurstPolling();
+    else
+        sendBurstRequest();
 }
 
 ///
@@ -586,6 +764,12 @@ void FormModSca::on_modbusRequest(int requestId, int deviceId, int transactionId
 {
    logRequest(requestId, deviceId, transactionId, request);
 
+    if(_burstActive && _burstTransactionId == -1 && requestId == _formId)
+        _burstTransactionId = transactionId;
+
+    if(_pollTime >= 0 && requestId == _formId)
+        RequestTracer::instance().mark(transactionId, RequestTracer::Scheduled, _pollTime);
+
     switch(request.functionCode())
     {
         case QModbusPdu::ReadCoils:
@@ -593,7 +777,10 @@ void FormModSca::on_modbusRequest(int requestId, int deviceId, int transactionId
         case QModbusPdu::ReadHoldingRegisters:
         case QModbusPdu::ReadInputRegisters:
             if(requestId == _formId)
+            {
                 ui->statisticWidget->increaseNumberOfPolls();
+                metrics(deviceId)->Polls.fetch_add(1, std::memory_order_relaxed);
+            }
         break;
 
         default:
@@ -625,6 +812,19 @@ void FormModSca::logReply(const QModbusReply* reply)
         ui->outputWidget->updateTraffic(reply->rawResult(), reply->serverAddress(), transactionId);
 }
 
+///
+/// \brief FormModSca::metrics
+/// \param deviceId
+/// \return exported counters of this form for the device on the current connection
+///
+ModbusMetrics::Series* FormModSca::metrics(int deviceId)
+{
+    if(!_metrics || _metrics->DeviceId != deviceId || _metrics->Connection != _modbusClient.connectionName())
+        _metrics = ModbusMetrics::instance().series(_modbusClient.connectionName(), deviceId, _formId);
+
+    return _metrics;
+}
+
 ///
 /// \brief FormModSca::on_modbusReply
 /// \param reply
@@ -654,6 +854,32 @@ void FormModSca::on_modbusReply(QModbusReply* reply)
     if(reply->property("RequestId").toInt() != _formId)
     return;
 
+    // issue the next burst read before spending time on the display
+    if(_burstActive)
+        updateBurstPolling(reply, !hasError && isValidReply(reply));
+
+    auto series = metrics(reply->serverAddress());
+    if(reply->error() == QModbusDevice::TimeoutError)
+    {
+        ui->statisticWidget->increaseTimeouts();
+        series->Timeouts.fetch_add(1, std::memory_order_relaxed);
+    }
+    else
+    {
+        if(ModbusClient::isDeviceReply(reply))
+        {
+            const auto rtt = ModbusClient::roundTripTime(reply);
+            ui->statisticWidget->addResponseTime(reply->serverAddress(), response.functionCode(), rtt);
+            series->addRoundTripTime(rtt);
+        }
+
+        if(reply->error() == QModbusDevice::ProtocolError)
+        {
+            ui->statisticWidget->increaseExceptions();
+            series->Exceptions.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
     if (!hasError)
     {
         if(!isValidReply(reply))
@@ -662,9 +888,24 @@ void FormModSca::on_modbusReply(QModbusReply* reply)
         }
         else
         {
-            ui->outputWidget->updateData(reply->result());
+            const auto transactionId = reply->property("TransactionId").toInt();
+
+            const auto data = reply->result();
+            auto& tracer = RequestTracer::instance();
+            tracer.mark(transactionId, RequestTracer::Decoded);
+
+            // every sample goes into the history, the view only shows the latest one per frame
+            ui->outputWidget->updateHistory(data);
+
+            // the trace record stays open until on_displayFrame has updated the model
+            tracer.hold(transactionId);
+            _pendingData = data;
+            _pendingTransactions.append(transactionId);
+            DisplayRefreshScheduler::instance().requestFrame();
+
             ui->outputWidget->setStatus(QString());
             ui->statisticWidget->increaseValidSlaveResponses();
+            series->ValidResponses.fetch_add(1, std::memory_order_relaxed);
         }
     }
     else if (reply->error() == QModbusDevice::ProtocolError)
@@ -699,7 +940,14 @@ void FormModSca::on_modbusConnected(const ConnectionDetails&)
 ///
 void FormModSca::on_modbusDisconnected(const ConnectionDetails&)
 {
+    stopBurstPolling();
     _timer.stop();
+    _scanClock.invalidate();
+
+    // show the data already received, no frame or paint may come for its trace records
+    on_displayFrame();
+    finishTransactions();
+
     ui->outputWidget->setStatus(tr("Device NOT CONNECTED!"));
 }
 
@@ -832,6 +1080,66 @@ void FormModSca::on_outputWidget_itemDoubleClicked(quint16 addr, const QVariant&
     }
 }
 
+///
+/// \brief FormModSca::on_displayFrame
+/// Shows the latest data received since the last frame
+///
+void FormModSca::on_displayFrame()
+{
+    if(_pendingTransactions.isEmpty())
+        return;
+
+    const auto data = _pendingData;
+    const auto transactions = _pendingTransactions;
+    _pendingData = QModbusDataUnit();
+    _pendingTransactions.clear();
+
+    auto& tracer = RequestTracer::instance();
+    const bool changed = ui->outputWidget->updateData(data);
+
+    for(auto&& transactionId : transactions)
+    {
+        tracer.mark(transactionId, RequestTracer::ModelUpdated);
+        if(!tracer.isEnabled())
+            continue;
+
+        // unchanged values are not repainted, older samples of the frame never are
+        if(changed && transactionId == transactions.last() && displayMode() == DisplayMode::Data && isVisible())
+            _unpaintedTransactions.append(transactionId);
+        else
+            tracer.finish(transactionId);
+    }
+}
+
+///
+/// \brief FormModSca::finishTransactions
+/// Finishes the trace records still held for a display frame or a paint
+///
+void FormModSca::finishTransactions()
+{
+    auto& tracer = RequestTracer::instance();
+    for(auto&& transactionId : std::as_const(_pendingTransactions))
+        tracer.finish(transactionId);
+
+    for(auto&& transactionId : std::as_const(_unpaintedTransactions))
+        tracer.finish(transactionId);
+
+    _pendingData = QModbusDataUnit();
+    _pendingTransactions.clear();
+    _unpaintedTransactions.clear();
+}
+
+///
+/// \brief FormModSca::on_outputWidget_dataPainted
+///
+void FormModSca::on_outputWidget_dataPainted()
+{
+    for(auto&& transactionId : std::as_const(_unpaintedTransactions))
+        RequestTracer::instance().mark(transactionId, RequestTracer::Painted);
+
+    _unpaintedTransactions.clear();
+}
+
 ///
 /// \brief FormModSca::on_statisticWidget_numberOfPollsChanged
 /// \param value
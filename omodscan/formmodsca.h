@@ -5,14 +5,14 @@
 #include <QTimer>
 #include <QPrinter>
 #include <QVersionNumber>
+#include <QElapsedTimer>
 #include "enums.h"
 #include "modbusclient.h"
 #include "datasimulator.h"
 #include "displaydefinition.h"
 #include "outputwidget.h"
 #include "modbussimulationparams.h"
-
-class MainWindow;
+#include "burstpolling.h"
 
 namespace Ui {
 class FormModSca;
@@ -31,7 +31,7 @@ class FormModSca : public QWidget
 public:
     static QVersionNumber VERSION;
 
-    explicit FormModSca(int id, ModbusClient& client, DataSimulator* simulator, MainWindow* parent);
+    explicit FormModSca(int id, ModbusClient& client, DataSimulator* simulator, QWidget* parent);
     ~FormModSca();
 
     int formId() const {
@@ -56,6 +56,9 @@ public:
     DataDisplayMode dataDisplayMode() const;
     void setDataDisplayMode(DataDisplayMode mode);
 
+    QVector<DataDisplayMode> extraColumns() const;
+    void setExtraColumns(const QVector<DataDisplayMode>& modes);
+
     ByteOrder byteOrder() const;
     void setByteOrder(ByteOrder order);
 
@@ -86,10 +89,18 @@ public:
     AddressDescriptionMap descriptionMap() const;
     void setDescription(QModbusDataUnit::RegisterType type, quint16 addr, const QString& desc);
 
+    qint64 memoryUsage() const;
+
     void resetCtrs();
     uint numberOfPolls() const;
     uint validSlaveResposes() const;
 
+    bool isBurstPolling() const {
+        return _burstActive;
+    }
+    BurstPollingError startBurstPolling(const BurstPollingParams& params);
+    void stopBurstPolling();
+
 public slots:
     void show();
 
@@ -98,6 +109,8 @@ signals:
     void byteOrderChanged(ByteOrder);
     void numberOfPollsChanged(uint value);
     void validSlaveResposesChanged(uint value);
+    void burstPollingProgress(int samples);
+    void burstPollingFinished(const BurstPollingResult& result);
 
 protected:
     void changeEvent(QEvent* event) override;
@@ -114,6 +127,8 @@ private slots:
     void on_comboBoxAddressBase_addressBaseChanged(AddressBase base);
     void on_comboBoxModbusPointType_pointTypeChanged(QModbusDataUnit::RegisterType);
     void on_outputWidget_itemDoubleClicked(quint16 addr, const QVariant& value);
+    void on_outputWidget_dataPainted();
+    void on_displayFrame();
     void on_statisticWidget_numberOfPollsChanged(uint value);
     void on_statisticWidget_validSlaveResposesChanged(uint value);
     void on_simulationStarted(QModbusDataUnit::RegisterType type, quint16 addr, quint8 deviceId);
@@ -122,9 +137,14 @@ private slots:
 
 private:
     void beginUpdate();
+    void restartScanClock();
+    void finishTransactions();
+    void sendBurstRequest();
+    void updateBurstPolling(const QModbusReply* reply, bool valid);
     bool isValidReply(const QModbusReply* reply) const;
 
     void logReply(const QModbusReply* reply);
+    ModbusMetrics::Series* metrics(int deviceId);
     void logRequest(int requestId, int deviceId, int transactionId, const QModbusRequest& request);
 
 private:
@@ -133,10 +153,24 @@ private:
     uint _validSlaveResponses;
     uint _noSlaveResponsesCounter;
     QTimer _timer;
+    QElapsedTimer _scanClock;
+    qint64 _scanDeadline;
     QString _filename;
     ModbusClient& _modbusClient;
     DataSimulator* _dataSimulator;
-    MainWindow* _parent;
+    QWidget* _parent;
+    ModbusMetrics::Series* _metrics;
+    qint64 _pollTime;
+    QList<int> _unpaintedTransactions;
+    QModbusDataUnit _pendingData;
+    QList<int> _pendingTransactions;
+
+    bool _burstActive;
+    int _burstTransactionId;
+    qint64 _burstRequestTime;
+    QElapsedTimer _burstClock;
+    BurstPollingParams _burstParams;
+    BurstPollingResult _burstResult;
 };
 
 ///
@@ -167,6 +201,11 @@ inline QSettings& operator <<(QSettings& out, const FormModSca* frm)
     out << frm->displayDefinition();
     out.setValue("DisplayHexAddresses", frm->displayHexAddresses());
 
+    QStringList extraColumns;
+    for(auto&& m : frm->extraColumns())
+        extraColumns.append(QString::number((uint)m));
+    out.setValue("ExtraColumns", extraColumns);
+
     return out;
 }
 
@@ -213,6 +252,11 @@ inline QSettings& operator >>(QSettings& in, FormModSca* frm)
     frm->setDisplayDefinition(displayDefinition);
     frm->setDisplayHexAddresses(in.value("DisplayHexAddresses").toBool());
 
+    QVector<DataDisplayMode> extraColumns;
+    for(auto&& m : in.value("ExtraColumns").toStringList())
+        extraColumns.append((DataDisplayMode)m.toUInt());
+    frm->setExtraColumns(extraColumns);
+
     return in;
 }
 
@@ -250,10 +294,12 @@ inline QDataStream& operator <<(QDataStream& out, const FormModSca* frm)
     out << dd.Length;
     out << dd.LogViewLimit;
     out << dd.ZeroBasedAddress;
+    out << dd.HistoryDepth;
 
     out << frm->byteOrder();
     out << frm->simulationMap();
     out << frm->descriptionMap();
+    out << frm->extraColumns();
 
     return out;
 }
@@ -310,6 +356,10 @@ inline QDataStream& operator >>(QDataStream& in, FormModSca* frm)
     {
         in >> dd.ZeroBasedAddress;
     }
+    if(ver >= QVersionNumber(1, 6))
+    {
+        in >> dd.HistoryDepth;
+    }
 
     ByteOrder byteOrder = ByteOrder::LittleEndian;
     ModbusSimulationMap simulationMap;
@@ -325,6 +375,12 @@ inline QDataStream& operator >>(QDataStream& in, FormModSca* frm)
         in >> descriptionMap;
     }
 
+    QVector<DataDisplayMode> extraColumns;
+    if(ver >= QVersionNumber(1, 7))
+    {
+        in >> extraColumns;
+    }
+
     if(in.status() != QDataStream::Ok)
         return in;
 
@@ -342,6 +398,7 @@ inline QDataStream& operator >>(QDataStream& in, FormModSca* frm)
     frm->setFont(font);
     frm->setDisplayDefinition(dd);
     frm->setByteOrder(byteOrder);
+    frm->setExtraColumns(extraColumns);
 
     for(auto&& k : simulationMap.keys())
         frm->startSimulation(k.first, k.second,  simulationMap[k]);
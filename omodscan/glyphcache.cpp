@@ -0,0 +1,203 @@
+#include <utility>
+#include <QtMath>
+#include <QPainter>
+#include <QCoreApplication>
+#include <QFontMetricsF>
+#include "glyphcache.h"
+
+///
+/// \brief MaxAtlases
+/// Number of font and color combinations kept, the least recently used one goes first
+///
+static constexpr int MaxAtlases = 8;
+
+///
+/// \brief GlyphCache::instance
+/// \return
+///
+GlyphCache& GlyphCache::instance()
+{
+    static GlyphCache cache;
+
+    // fonts must not outlive the application
+    static const bool registered = [] {
+        qAddPostRoutine([] { GlyphCache::instance().clear(); });
+        return true;
+    }();
+    Q_UNUSED(registered)
+
+    return cache;
+}
+
+///
+/// \brief GlyphCache::clear
+/// Drops all atlases, e.g. when the fonts of the system have changed
+///
+void GlyphCache::clear()
+{
+    _atlases.clear();
+}
+
+///
+/// \brief GlyphCache::atlas
+/// \param font
+/// \param color
+/// \param ratio device pixel ratio the glyphs are rendered for
+/// \return the atlas of the font and color, rendered if it is not cached yet
+///
+const GlyphCache::Atlas& GlyphCache::atlas(const QFont& font, QRgb color, qreal ratio)
+{
+    for(int i = 0; i < _atlases.size(); i++)
+    {
+        const auto& a = _atlases.at(i);
+        if(a->Color == color && qFuzzyCompare(a->Ratio, ratio) && a->Font == font)
+        {
+            if(i > 0) _atlases.move(i, 0);
+            return *_atlases.first();
+        }
+    }
+
+    auto a = QSharedPointer<Atlas>::create();
+    a->Font = font;
+    a->Color = color;
+    a->Ratio = ratio;
+
+    const QFontMetricsF fm(font);
+    a->Ascent = fm.ascent();
+    a->Height = fm.height();
+    a->Padding = qCeil(fm.height() / 8) + 1;
+
+    int width = 0;
+    for(int g = 0; g < GlyphCount; g++)
+    {
+        a->Advances[g] = fm.horizontalAdvance(QChar(ushort(FirstGlyph + g)));
+        a->Cells[g] = width;
+        width += qCeil(a->Advances[g]) + 2 * a->Padding;
+    }
+
+    const int height = qCeil(a->Height) + 2 * a->Padding;
+    a->Image = QImage(qCeil(width * ratio), qCeil(height * ratio), QImage::Format_ARGB32_Premultiplied);
+    a->Image.setDevicePixelRatio(ratio);
+    a->Image.fill(Qt::transparent);
+
+    QPainter painter(&a->Image);
+    painter.setRenderHint(QPainter::TextAntialiasing);
+    painter.setFont(font);
+    painter.setPen(QColor::fromRgba(color));
+    for(int g = 0; g < GlyphCount; g++)
+        painter.drawText(QPointF(a->Cells[g] + a->Padding, a->Padding + a->Ascent), QString(QChar(ushort(FirstGlyph + g))));
+    painter.end();
+
+    _atlases.prepend(a);
+    if(_atlases.size() > MaxAtlases)
+        _atlases.removeLast();
+
+    return *a;
+}
+
+///
+/// \brief GlyphCache::drawText
+/// Draws a single line left aligned and vertically centered with the font and pen
+/// of the painter. Glyphs that would cross the right edge are left out.
+/// \param painter
+/// \param rc
+/// \param text
+/// \return the position after the last glyph drawn
+///
+qreal GlyphCache::drawText(QPainter& painter, const QRectF& rc, const QString& text)
+{
+    const auto device = painter.device();
+    const qreal ratio = device ? device->devicePixelRatioF() : 1;
+    const auto& a = atlas(painter.font(), painter.pen().color().rgba(), ratio);
+
+    const qreal baseline = rc.top() + (rc.height() - a.Height) / 2 + a.Ascent;
+    const qreal cellHeight = a.Height + 2 * a.Padding;
+    qreal x = rc.left();
+
+    // characters outside the atlas are laid out as text
+    auto drawRun = [&](int from, int to) {
+        const auto run = text.mid(from, to - from);
+        painter.drawText(QPointF(x, baseline), run);
+        x += QFontMetricsF(painter.font(), device).horizontalAdvance(run);
+        return x <= rc.right();
+    };
+
+    int runStart = -1;
+    for(int i = 0; i < text.size(); i++)
+    {
+        const auto c = text.at(i);
+        if(!inAtlas(c))
+        {
+            if(runStart < 0) runStart = i;
+            continue;
+        }
+
+        if(runStart >= 0)
+        {
+            if(!drawRun(runStart, i)) return x;
+            runStart = -1;
+        }
+
+        const int g = c.unicode() - FirstGlyph;
+        const qreal advance = a.Advances[g];
+        if(x + advance > rc.right())
+            return x;
+
+        if(c != QLatin1Char(' '))
+        {
+            const qreal cellWidth = qCeil(advance) + 2 * a.Padding;
+            painter.drawImage(QRectF(x - a.Padding, baseline - a.Ascent - a.Padding, cellWidth, cellHeight), a.Image,
+                               QRectF(a.Cells[g] * ratio, 0, cellWidth * ratio, cellHeight * ratio));
+        }
+
+        x += advance;
+    }
+
+    if(runStart >= 0)
+        drawRun(runStart, text.size());
+
+    return x;
+}
+
+///
+/// \brief GlyphCache::horizontalAdvance
+/// \param font
+/// \param text
+/// \return the width drawText takes for the text
+///
+qreal GlyphCache::horizontalAdvance(const QFont& font, const QString& text)
+{
+    const Atlas* a = nullptr;
+    for(auto&& cached : std::as_const(_atlases))
+    {
+        if(cached->Font == font)
+        {
+            a = cached.data();
+            break;
+        }
+    }
+
+    if(!a) a = &atlas(font, qRgba(0, 0, 0, 255), 1);
+
+    qreal width = 0;
+    int runStart = -1;
+    for(int i = 0; i <= text.size(); i++)
+    {
+        if(i < text.size() && !inAtlas(text.at(i)))
+        {
+            if(runStart < 0) runStart = i;
+            continue;
+        }
+
+        if(runStart >= 0)
+        {
+            width += QFontMetricsF(font).horizontalAdvance(text.mid(runStart, i - runStart));
+            runStart = -1;
+        }
+
+        if(i < text.size())
+            width += a->Advances[text.at(i).unicode() - FirstGlyph];
+    }
+
+    return width;
+}
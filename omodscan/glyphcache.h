@@ -0,0 +1,61 @@
+#ifndef GLYPHCACHE_H
+#define GLYPHCACHE_H
+
+#include <QFont>
+#include <QColor>
+#include <QImage>
+#include <QVector>
+#include <QSharedPointer>
+
+class QPainter;
+
+///
+/// \brief The GlyphCache class
+/// Draws the digits, letters and punctuation the views are mostly made of from
+/// glyphs rendered once per font and color into an atlas image, so painting a
+/// value is a run of image blits instead of laying the text out every time.
+/// Characters outside the atlas are drawn as text. Kerning is not applied
+/// between atlas glyphs, which makes no difference to the fixed-width digits.
+///
+class GlyphCache
+{
+public:
+    static GlyphCache& instance();
+
+    qreal drawText(QPainter& painter, const QRectF& rc, const QString& text);
+    qreal horizontalAdvance(const QFont& font, const QString& text);
+
+    void clear();
+
+private:
+    GlyphCache() = default;
+    Q_DISABLE_COPY(GlyphCache)
+
+    static constexpr ushort FirstGlyph = 0x20;
+    static constexpr ushort LastGlyph = 0x7e;
+    static constexpr int GlyphCount = LastGlyph - FirstGlyph + 1;
+
+    struct Atlas
+    {
+        QFont Font;
+        QRgb Color = 0;
+        qreal Ratio = 1;
+        QImage Image;
+        qreal Ascent = 0;
+        qreal Height = 0;
+        int Padding = 0;
+        qreal Advances[GlyphCount] = {};
+        int Cells[GlyphCount] = {};
+    };
+
+    static bool inAtlas(QChar c) {
+        return c.unicode() >= FirstGlyph && c.unicode() <= LastGlyph;
+    }
+
+    const Atlas& atlas(const QFont& font, QRgb color, qreal ratio);
+
+private:
+    QVector<QSharedPointer<Atlas>> _atlases;
+};
+
+#endif // GLYPHCACHE_H
@@ -0,0 +1,457 @@
+#include <QFont>
+#include <QSize>
+#include <QColor>
+#include <QDateTime>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QJsonDocument>
+#include <QVersionNumber>
+#include "formatutils.h"
+#include "formatpipeline.h"
+#include "modbuslimits.h"
+#include "formmodsca.h"
+#include "headlesspoller.h"
+
+///
+/// \brief plainValue
+/// \param str formatted value as shown in the output view
+/// \return value without display decorations
+///
+static QString plainValue(const QString& str)
+{
+    if(str.startsWith('<') && str.endsWith('>'))
+        return str.mid(1, str.length() - 2);
+
+    return str;
+}
+
+///
+/// \brief jsonValue
+/// \param mode
+/// \param str
+/// \param value
+/// \return
+///
+static QJsonValue jsonValue(DataDisplayMode mode, const QString& str, const QVariant& value)
+{
+    switch(mode)
+    {
+        case DataDisplayMode::Binary:
+        case DataDisplayMode::Hex:
+        case DataDisplayMode::Int64:
+        case DataDisplayMode::SwappedInt64:
+        case DataDisplayMode::UInt64:
+        case DataDisplayMode::SwappedUInt64:
+            // keep all digits, JSON numbers are doubles
+            return plainValue(str);
+
+        default:
+            return QJsonValue::fromVariant(value);
+    }
+}
+
+///
+/// \brief HeadlessPoller::HeadlessPoller
+/// \param parent
+///
+HeadlessPoller::HeadlessPoller(QObject* parent)
+    : QObject(parent)
+    ,_running(false)
+    ,_format(Csv)
+    ,_numberOfPolls(0)
+    ,_validResponses(0)
+{
+    connect(&_modbusClient, &ModbusClient::modbusConnected, this, &HeadlessPoller::on_modbusConnected);
+    connect(&_modbusClient, &ModbusClient::modbusDisconnected, this, &HeadlessPoller::on_modbusDisconnected);
+    connect(&_modbusClient, &ModbusClient::modbusConnectionError, this, &HeadlessPoller::on_modbusConnectionError);
+    connect(&_modbusClient, &ModbusClient::modbusReply, this, &HeadlessPoller::on_modbusReply);
+}
+
+///
+/// \brief HeadlessPoller::~HeadlessPoller
+///
+HeadlessPoller::~HeadlessPoller()
+{
+    stop();
+}
+
+///
+/// \brief HeadlessPoller::load
+/// Reads a workspace written by MainWindow::saveConfig and the form files it refers to
+/// \param filename
+/// \return
+///
+bool HeadlessPoller::load(const QString& filename)
+{
+    QFile file(filename);
+    if(!file.open(QFile::ReadOnly))
+    {
+        _errorString = tr("Cannot open %1").arg(filename);
+        return false;
+    }
+
+    QDataStream s(&file);
+    s.setByteOrder(QDataStream::BigEndian);
+    s.setVersion(QDataStream::Version::Qt_5_0);
+
+    quint8 magic = 0;
+    s >> magic;
+
+    QVersionNumber ver;
+    s >> ver;
+
+    if(magic != 0x33 || ver != QVersionNumber(1, 0))
+    {
+        _errorString = tr("%1 is not a workspace file").arg(filename);
+        return false;
+    }
+
+    QStringList listFilename;
+    s >> listFilename;
+
+    ConnectionDetails connParams;
+    s >> connParams;
+
+    if(s.status() != QDataStream::Ok)
+    {
+        _errorString = tr("%1 is corrupted").arg(filename);
+        return false;
+    }
+
+    _connParams = connParams;
+    _definitions.clear();
+
+    for(auto&& formFile : listFilename)
+    {
+        if(!formFile.isEmpty() && !loadForm(formFile))
+            return false;
+    }
+
+    if(_definitions.isEmpty())
+    {
+        _errorString = tr("%1 has no poll definitions").arg(filename);
+        return false;
+    }
+
+    return true;
+}
+
+///
+/// \brief HeadlessPoller::loadForm
+/// Mirrors the layout of operator >>(QDataStream&, FormModSca*)
+/// \param filename
+/// \return
+///
+bool HeadlessPoller::loadForm(const QString& filename)
+{
+    QFile file(filename);
+    if(!file.open(QFile::ReadOnly))
+    {
+        _errorString = tr("Cannot open %1").arg(filename);
+        return false;
+    }
+
+    QDataStream s(&file);
+    s.setByteOrder(QDataStream::BigEndian);
+    s.setVersion(QDataStream::Version::Qt_5_0);
+
+    quint8 magic = 0;
+    s >> magic;
+
+    QVersionNumber ver;
+    s >> ver;
+
+    if(magic != 0x32 || ver > FormModSca::VERSION)
+    {
+        _errorString = tr("%1 is not a supported form file").arg(filename);
+        return false;
+    }
+
+    PollDefinition def;
+    s >> def.FormId;
+
+    bool isMaximized;
+    s >> isMaximized;
+
+    QSize windowSize;
+    s >> windowSize;
+
+    DisplayMode displayMode;
+    s >> displayMode;
+
+    s >> def.Mode;
+    s >> def.HexAddresses;
+
+    QColor bkgClr, fgClr, stClr;
+    s >> bkgClr >> fgClr >> stClr;
+
+    QFont font;
+    s >> font;
+
+    s >> def.Dd.ScanRate;
+    s >> def.Dd.DeviceId;
+    s >> def.Dd.PointType;
+    s >> def.Dd.PointAddress;
+    s >> def.Dd.Length;
+    if(ver >= QVersionNumber(1, 4))
+    {
+        s >> def.Dd.LogViewLimit;
+    }
+    if(ver >= QVersionNumber(1, 5))
+    {
+        s >> def.Dd.ZeroBasedAddress;
+    }
+    if(ver >= QVersionNumber(1, 6))
+    {
+        s >> def.Dd.HistoryDepth;
+    }
+    if(ver >= QVersionNumber(1, 1))
+    {
+        s >> def.Order;
+    }
+
+    if(s.status() != QDataStream::Ok)
+    {
+        _errorString = tr("%1 is corrupted").arg(filename);
+        return false;
+    }
+
+    def.Dd.normalize();
+    _definitions.append(def);
+
+    return true;
+}
+
+///
+/// \brief HeadlessPoller::setOutput
+/// \param filename output file, or empty for the standard output
+/// \param format
+/// \return
+///
+bool HeadlessPoller::setOutput(const QString& filename, OutputFormat format)
+{
+    _format = format;
+
+    if(_file.isOpen())
+        _file.close();
+
+    if(filename.isEmpty())
+    {
+        if(!_file.open(stdout, QFile::WriteOnly))
+            return false;
+    }
+    else
+    {
+        _file.setFileName(filename);
+        if(!_file.open(QFile::WriteOnly | QFile::Truncate))
+        {
+            _errorString = tr("Cannot open %1").arg(filename);
+            return false;
+        }
+    }
+
+    _out.setDevice(&_file);
+    return true;
+}
+
+///
+/// \brief HeadlessPoller::start
+///
+void HeadlessPoller::start()
+{
+    if(_running)
+        return;
+
+    if(!_out.device())
+        setOutput(QString(), _format);
+
+    writeHeader();
+
+    for(auto&& def : _definitions)
+    {
+        def.Timer = new QTimer(this);
+        def.Timer->setInterval(def.Dd.ScanRate);
+
+        const auto formId = def.FormId;
+        connect(def.Timer, &QTimer::timeout, this, [this, formId]
+        {
+            for(auto&& d : std::as_const(_definitions))
+                if(d.FormId == formId) poll(d);
+        });
+    }
+
+    _running = true;
+    _modbusClient.connectDevice(_connParams);
+}
+
+///
+/// \brief HeadlessPoller::stop
+///
+void HeadlessPoller::stop()
+{
+    if(!_running)
+        return;
+
+    _running = false;
+    for(auto&& def : _definitions)
+    {
+        delete def.Timer;
+        def.Timer = nullptr;
+    }
+
+    _modbusClient.disconnectDevice();
+    _out.flush();
+}
+
+///
+/// \brief HeadlessPoller::poll
+/// \param def
+///
+void HeadlessPoller::poll(const PollDefinition& def)
+{
+    if(_modbusClient.state() != QModbusDevice::ConnectedState)
+        return;
+
+    const auto dd = def.Dd;
+    const auto addr = dd.PointAddress - (dd.ZeroBasedAddress ? 0 : 1);
+    if(addr + dd.Length > ModbusLimits::addressRange(dd.ZeroBasedAddress).to())
+        return;
+
+    _numberOfPolls++;
+    if(def.Metrics) def.Metrics->Polls.fetch_add(1, std::memory_order_relaxed);
+
+    _modbusClient.sendReadRequest(dd.PointType, addr, dd.Length, dd.DeviceId, def.FormId);
+}
+
+///
+/// \brief HeadlessPoller::on_modbusConnected
+///
+void HeadlessPoller::on_modbusConnected(const ConnectionDetails&)
+{
+    for(auto&& def : _definitions)
+        def.Metrics = ModbusMetrics::instance().series(_modbusClient.connectionName(), def.Dd.DeviceId, def.FormId);
+
+    for(auto&& def : std::as_const(_definitions))
+    {
+        poll(def);
+        if(def.Timer) def.Timer->start();
+    }
+}
+
+///
+/// \brief HeadlessPoller::on_modbusDisconnected
+///
+void HeadlessPoller::on_modbusDisconnected(const ConnectionDetails&)
+{
+    for(auto&& def : std::as_const(_definitions))
+        if(def.Timer) def.Timer->stop();
+
+    // keep the poller alive across link drops
+    if(_running)
+        QTimer::singleShot(1000, this, [this]{ if(_running) _modbusClient.connectDevice(_connParams); });
+}
+
+///
+/// \brief HeadlessPoller::on_modbusConnectionError
+/// \param error
+///
+void HeadlessPoller::on_modbusConnectionError(const QString& error)
+{
+    qWarning().noquote() << error;
+}
+
+///
+/// \brief HeadlessPoller::on_modbusReply
+/// \param reply
+///
+void HeadlessPoller::on_modbusReply(QModbusReply* reply)
+{
+    if(!reply) return;
+
+    const auto formId = reply->property("RequestId").toInt();
+    for(auto&& def : std::as_const(_definitions))
+    {
+        if(def.FormId != formId)
+            continue;
+
+        if(auto metrics = def.Metrics)
+        {
+            if(reply->error() == QModbusDevice::TimeoutError)
+                metrics->Timeouts.fetch_add(1, std::memory_order_relaxed);
+            else if(ModbusClient::isDeviceReply(reply))
+                metrics->addRoundTripTime(ModbusClient::roundTripTime(reply));
+
+            if(reply->error() == QModbusDevice::ProtocolError)
+                metrics->Exceptions.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        if(reply->error() == QModbusDevice::NoError && reply->serverAddress() == def.Dd.DeviceId)
+        {
+            _validResponses++;
+            if(def.Metrics) def.Metrics->ValidResponses.fetch_add(1, std::memory_order_relaxed);
+
+            writeData(def, reply->result());
+        }
+        break;
+    }
+}
+
+///
+/// \brief HeadlessPoller::writeHeader
+///
+void HeadlessPoller::writeHeader()
+{
+    if(_format == Csv)
+    {
+        _out << "Time,Form,Device,Address,Value\n";
+        _out.flush();
+    }
+}
+
+///
+/// \brief HeadlessPoller::writeData
+/// \param def
+/// \param data
+///
+void HeadlessPoller::writeData(const PollDefinition& def, const QModbusDataUnit& data)
+{
+    const auto time = QDateTime::currentDateTime().toString(Qt::ISODateWithMs);
+    const auto count = qMin<int>(def.Dd.Length, data.valueCount());
+
+    DecodedRegisters decoded;
+    decoded.decode(data, count, def.Mode, def.Order);
+    const auto pipeline = formatPipeline(def.Dd.PointType, def.Mode, def.Order);
+
+    QJsonArray values;
+    for(int i = 0; i < count; i++)
+    {
+        QVariant value;
+        const auto str = pipeline(data, decoded, i, count, value);
+        if(str.isEmpty())
+            continue;
+
+        const auto address = formatAddress(def.Dd.PointType, def.Dd.PointAddress + i, def.HexAddresses);
+        if(_format == Csv)
+        {
+            _out << time << ',' << def.FormId << ',' << def.Dd.DeviceId << ','
+                 << address << ',' << plainValue(str) << '\n';
+        }
+        else
+        {
+            values.append(QJsonObject{{ "address", address }, { "value", jsonValue(def.Mode, str, value) }});
+        }
+    }
+
+    if(_format == JsonLines)
+    {
+        const QJsonObject obj {
+            { "time", time },
+            { "form", def.FormId },
+            { "device", def.Dd.DeviceId },
+            { "values", values }
+        };
+        _out << QJsonDocument(obj).toJson(QJsonDocument::Compact) << '\n';
+    }
+
+    _out.flush();
+}
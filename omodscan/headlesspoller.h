@@ -0,0 +1,88 @@
+#ifndef HEADLESSPOLLER_H
+#define HEADLESSPOLLER_H
+
+#include <QFile>
+#include <QTimer>
+#include <QTextStream>
+#include <QElapsedTimer>
+#include "enums.h"
+#include "modbusclient.h"
+#include "displaydefinition.h"
+
+///
+/// \brief The HeadlessPoller class
+/// Runs the poll definitions of a saved workspace without any widgets
+/// and streams the decoded values as CSV or JSON lines
+///
+class HeadlessPoller : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum OutputFormat
+    {
+        Csv = 0,
+        JsonLines
+    };
+
+    explicit HeadlessPoller(QObject* parent = nullptr);
+    ~HeadlessPoller() override;
+
+    bool load(const QString& filename);
+    bool setOutput(const QString& filename, OutputFormat format);
+
+    QString errorString() const {
+        return _errorString;
+    }
+
+    void start();
+    void stop();
+
+    quint64 numberOfPolls() const {
+        return _numberOfPolls;
+    }
+
+    quint64 validResponses() const {
+        return _validResponses;
+    }
+
+private slots:
+    void on_modbusConnected(const ConnectionDetails& cd);
+    void on_modbusDisconnected(const ConnectionDetails& cd);
+    void on_modbusConnectionError(const QString& error);
+    void on_modbusReply(QModbusReply* reply);
+
+private:
+    struct PollDefinition
+    {
+        int FormId = 0;
+        DisplayDefinition Dd;
+        DataDisplayMode Mode = DataDisplayMode::UInt16;
+        ByteOrder Order = ByteOrder::LittleEndian;
+        bool HexAddresses = false;
+        QTimer* Timer = nullptr;
+        ModbusMetrics::Series* Metrics = nullptr;
+    };
+
+    bool loadForm(const QString& filename);
+    void poll(const PollDefinition& def);
+    void writeHeader();
+    void writeData(const PollDefinition& def, const QModbusDataUnit& data);
+
+private:
+    QString _errorString;
+    ConnectionDetails _connParams;
+    QList<PollDefinition> _definitions;
+
+    ModbusClient _modbusClient;
+    bool _running;
+
+    OutputFormat _format;
+    QFile _file;
+    QTextStream _out;
+
+    quint64 _numberOfPolls;
+    quint64 _validResponses;
+};
+
+#endif // HEADLESSPOLLER_H
@@ -0,0 +1,103 @@
+#include <QtAlgorithms>
+#include "latencyhistogram.h"
+
+///
+/// \brief LatencyHistogram::LatencyHistogram
+///
+LatencyHistogram::LatencyHistogram()
+{
+    reset();
+}
+
+///
+/// \brief LatencyHistogram::reset
+///
+void LatencyHistogram::reset()
+{
+    _buckets.fill(0);
+    _count = 0;
+    _min = 0;
+    _max = 0;
+    _sum = 0;
+}
+
+///
+/// \brief LatencyHistogram::record
+/// \param usecs
+///
+void LatencyHistogram::record(qint64 usecs)
+{
+    const auto value = qBound<qint64>(0, usecs, (Q_INT64_C(1) << MaxValueBits) - 1);
+
+    _buckets[bucketIndex(value)]++;
+    _min = _count ? qMin(_min, value) : value;
+    _max = qMax(_max, value);
+    _sum += value;
+    _count++;
+}
+
+///
+/// \brief LatencyHistogram::mean
+/// \return
+///
+double LatencyHistogram::mean() const
+{
+    return _count ? _sum / _count : 0;
+}
+
+///
+/// \brief LatencyHistogram::percentile
+/// \param p percentile in range 0..100
+/// \return the highest value equivalent to the bucket the percentile falls in
+///
+qint64 LatencyHistogram::percentile(double p) const
+{
+    if(_count == 0)
+        return 0;
+
+    const auto target = qMax<quint64>(1, quint64(qBound(0.0, p, 100.0) / 100.0 * _count + 0.5));
+
+    quint64 total = 0;
+    for(int i = 0; i < BucketCount; i++)
+    {
+        total += _buckets[i];
+        if(total >= target)
+            return qBound<qint64>(_min, bucketUpperBound(i), _max);
+    }
+
+    return _max;
+}
+
+///
+/// \brief LatencyHistogram::bucketIndex
+/// \param value
+/// \return
+///
+int LatencyHistogram::bucketIndex(quint64 value)
+{
+    if(value < 2 * SubBucketCount)
+        return int(value);
+
+    const int msb = 63 - qCountLeadingZeroBits(value);
+    const int shift = msb - SubBucketBits;
+    const int sub = int(value >> shift) - SubBucketCount;
+
+    return 2 * SubBucketCount + (shift - 1) * SubBucketCount + sub;
+}
+
+///
+/// \brief LatencyHistogram::bucketUpperBound
+/// \param index
+/// \return
+///
+quint64 LatencyHistogram::bucketUpperBound(int index)
+{
+    if(index < 2 * SubBucketCount)
+        return quint64(index);
+
+    const int k = index - 2 * SubBucketCount;
+    const int shift = k / SubBucketCount + 1;
+    const quint64 sub = k % SubBucketCount + SubBucketCount;
+
+    return ((sub + 1) << shift) - 1;
+}
@@ -0,0 +1,44 @@
+#ifndef LATENCYHISTOGRAM_H
+#define LATENCYHISTOGRAM_H
+
+#include <array>
+#include <QtGlobal>
+
+///
+/// \brief The LatencyHistogram class
+/// Log-linear (HDR style) histogram of latencies in microseconds.
+/// Every power of two range is split into 16 linear sub-buckets,
+/// so a recorded value is kept with ~6% relative precision.
+///
+class LatencyHistogram
+{
+public:
+    LatencyHistogram();
+
+    void record(qint64 usecs);
+    void reset();
+
+    quint64 count() const { return _count; }
+    qint64 min() const { return _count ? _min : 0; }
+    qint64 max() const { return _max; }
+    double mean() const;
+    qint64 percentile(double p) const;
+
+private:
+    static int bucketIndex(quint64 value);
+    static quint64 bucketUpperBound(int index);
+
+private:
+    static constexpr int SubBucketBits = 4;
+    static constexpr int SubBucketCount = 1 << SubBucketBits;
+    static constexpr int MaxValueBits = 36;
+    static constexpr int BucketCount = 2 * SubBucketCount + (MaxValueBits - SubBucketBits - 1) * SubBucketCount;
+
+    std::array<quint32, BucketCount> _buckets;
+    quint64 _count;
+    qint64 _min;
+    qint64 _max;
+    double _sum;
+};
+
+#endif // LATENCYHISTOGRAM_H
@@ -1,5 +1,98 @@
+#include <cstring>
+#include <QTimer>
 #include <QApplication>
+#include <QCommandLineParser>
 #include "mainwindow.h"
+#include "headlesspoller.h"
+#include "metricsserver.h"
+
+///
+/// \brief isHeadless
+/// \param argc
+/// \param argv
+/// \return true if the application must run without any widgets
+///
+static bool isHeadless(int argc, char *argv[])
+{
+    for(int i = 1; i < argc; i++)
+    {
+        if(!strcmp(argv[i], "--headless") || !strncmp(argv[i], "--headless=", 11))
+            return true;
+    }
+    return false;
+}
+
+///
+/// \brief runHeadless
+/// \param argc
+/// \param argv
+/// \return
+///
+static int runHeadless(int argc, char *argv[])
+{
+    // fonts and colors in form files need a GUI application, but never a display
+    if(qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "minimal");
+
+    QGuiApplication a(argc, argv);
+    a.setApplicationName(APP_NAME);
+    a.setApplicationVersion(APP_VERSION);
+
+    // machine readable numbers regardless of the system locale
+    QLocale::setDefault(QLocale::c());
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(APP_DESCRIPTION);
+    parser.addHelpOption();
+    parser.addVersionOption();
+
+    const QCommandLineOption headlessOption("headless", "Poll the workspace <file> without user interface.", "file");
+    const QCommandLineOption formatOption("format", "Output format: csv or jsonl.", "format", "csv");
+    const QCommandLineOption outputOption("output", "Write values to <file> instead of the standard output.", "file");
+    const QCommandLineOption durationOption("duration", "Stop after <seconds>.", "seconds");
+    const QCommandLineOption metricsPortOption("metrics-port", "Serve Prometheus metrics at http://localhost:<port>/metrics.", "port");
+    parser.addOptions({ headlessOption, formatOption, outputOption, durationOption, metricsPortOption });
+    parser.process(a);
+
+    const auto format = parser.value(formatOption).toLower();
+    if(format != "csv" && format != "jsonl")
+    {
+        qCritical().noquote() << "Unknown output format:" << format;
+        return 1;
+    }
+
+    HeadlessPoller poller;
+    if(!poller.load(parser.value(headlessOption)) ||
+       !poller.setOutput(parser.value(outputOption), format == "csv" ? HeadlessPoller::Csv : HeadlessPoller::JsonLines))
+    {
+        qCritical().noquote() << poller.errorString();
+        return 1;
+    }
+
+    MetricsServer metricsServer;
+    if(parser.isSet(metricsPortOption) && !metricsServer.start(parser.value(metricsPortOption).toUShort()))
+    {
+        qCritical().noquote() << metricsServer.errorString();
+        return 1;
+    }
+
+    if(parser.isSet(durationOption))
+        QTimer::singleShot(parser.value(durationOption).toInt() * 1000, &a, &QCoreApplication::quit);
+
+    QElapsedTimer timer;
+    timer.start();
+    poller.start();
+
+    const int ret = a.exec();
+    poller.stop();
+
+    const auto secs = timer.elapsed() / 1000.0;
+    qInfo().noquote() << QString("Polls: %1, valid responses: %2, polls/s: %3")
+                         .arg(poller.numberOfPolls()).arg(poller.validResponses())
+                         .arg(secs > 0 ? poller.numberOfPolls() / secs : 0, 0, 'f', 1);
+
+    return ret;
+}
 
 ///
 /// \brief main
@@ -9,11 +102,22 @@
 ///
 int main(int argc, char *argv[])
 {
+    if(isHeadless(argc, argv))
+        return runHeadless(argc, argv);
+
     QApplication a(argc, argv);
     a.setApplicationName(APP_NAME);
     a.setApplicationVersion(APP_VERSION);
 
+    QCommandLineParser parser;
+    const QCommandLineOption metricsPortOption("metrics-port", "Serve Prometheus metrics at http://localhost:<port>/metrics.", "port");
+    parser.addOption(metricsPortOption);
+    parser.parse(a.arguments());
+
     MainWindow w;
+    if(parser.isSet(metricsPortOption))
+        w.startMetricsServer(parser.value(metricsPortOption).toUShort());
+
     w.show();
     return a.exec();
 }
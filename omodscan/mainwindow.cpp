@@ -13,10 +13,14 @@
 #include "dialogusermsg.h"
 #include "dialogmsgparser.h"
 #include "dialogaddressscan.h"
+#include "dialogburstpolling.h"
 #include "dialogmodbusscanner.h"
 #include "dialogwindowsmanager.h"
 #include "dialogabout.h"
 #include "mainstatusbar.h"
+#include "requesttracer.h"
+#include "memorybudget.h"
+#include "displayrefreshscheduler.h"
 #include "mainwindow.h"
 #include "ui_mainwindow.h"
 
@@ -34,6 +38,7 @@ MainWindow::MainWindow(QWidget *parent)
     ,_autoStart(false)
     ,_selectedPrinter(nullptr)
     ,_dataSimulator(new DataSimulator(this))
+    ,_metricsPort(0)
 {
     ui->setupUi(this);
 
@@ -47,6 +52,7 @@ MainWindow::MainWindow(QWidget *parent)
     ui->actionByteOrder->setMenu(menuByteOrder);
     ui->actionByteOrder->setIcon(_icoLittleEndian);
     qobject_cast<QToolButton*>(ui->toolBarDisplay->widgetForAction(ui->actionByteOrder))->setPopupMode(QToolButton::InstantPopup);
+    setupExtraColumnsMenu();
 
     const auto defaultPrinter = QPrinterInfo::defaultPrinter();
     if(!defaultPrinter.isNull())
@@ -104,6 +110,29 @@ void MainWindow::setLanguage(const QString& lang)
     }
 }
 
+///
+/// \brief MainWindow::startMetricsServer
+/// Serves the polling counters in Prometheus format at http://localhost:<port>/metrics
+/// \param port
+/// \return
+///
+bool MainWindow::startMetricsServer(quint16 port)
+{
+    if(port == 0)
+    {
+        _metricsServer.stop();
+        return true;
+    }
+
+    if(!_metricsServer.start(port))
+    {
+        qWarning().noquote() << QString("Cannot start metrics server on port %1: %2").arg(port).arg(_metricsServer.errorString());
+        return false;
+    }
+
+    return true;
+}
+
 ///
 /// \brief MainWindow::changeEvent
 /// \param event
@@ -113,6 +142,7 @@ void MainWindow::changeEvent(QEvent* event)
     if (event->type() == QEvent::LanguageChange)
     {
         ui->retranslateUi(this);
+        setupExtraColumnsMenu();
     }
 
     QMainWindow::changeEvent(event);
@@ -131,6 +161,10 @@ void MainWindow::closeEvent(QCloseEvent* event)
     {
         event->ignore();
     }
+    else
+    {
+        RequestTracer::instance().stop();
+    }
 
     QMainWindow::closeEvent(event);
 }
@@ -195,8 +229,11 @@ void MainWindow::on_awake()
     ui->actionMaskWrite->setEnabled(state == QModbusDevice::ConnectedState);
     ui->actionUserMsg->setEnabled(state == QModbusDevice::ConnectedState);
     ui->actionAddressScan->setEnabled(state == QModbusDevice::ConnectedState);
+    ui->actionBurstPolling->setEnabled(frm && state == QModbusDevice::ConnectedState);
     ui->actionTextCapture->setEnabled(frm && frm->captureMode() == CaptureMode::Off);
     ui->actionCaptureOff->setEnabled(frm && frm->captureMode() == CaptureMode::TextCapture);
+    ui->actionStartTrace->setEnabled(!RequestTracer::instance().isEnabled());
+    ui->actionStopTrace->setEnabled(RequestTracer::instance().isEnabled());
     ui->actionResetCtrs->setEnabled(frm != nullptr);
 
     ui->actionToolbar->setChecked(ui->toolBarMain->isVisible());
@@ -226,6 +263,14 @@ void MainWindow::on_awake()
         ui->actionDblFloat->setChecked(ddm == DataDisplayMode::DblFloat);
         ui->actionSwappedDbl->setChecked(ddm == DataDisplayMode::SwappedDbl);
 
+        const auto extraColumns = frm->extraColumns();
+        for(auto&& action : ui->menuExtraColumns->actions())
+        {
+            const auto mode = (DataDisplayMode)action->data().toUInt();
+            action->setChecked(extraColumns.contains(mode));
+            action->setEnabled(mode != ddm);
+        }
+
         const auto byteOrder = frm->byteOrder();
         ui->actionLittleEndian->setChecked(byteOrder == ByteOrder::LittleEndian);
         ui->actionBigEndian->setChecked(byteOrder == ByteOrder::BigEndian);
@@ -287,6 +332,7 @@ void MainWindow::on_actionNew_triggered()
         frm->setByteOrder(cur->byteOrder());
         frm->setDisplayMode(cur->displayMode());
         frm->setDataDisplayMode(cur->dataDisplayMode());
+        frm->setExtraColumns(cur->extraColumns());
         frm->setDisplayDefinition(cur->displayDefinition());
 
         frm->setFont(cur->font());
@@ -634,6 +680,26 @@ void MainWindow::on_actionSwappedDbl_triggered()
     updateDataDisplayMode(DataDisplayMode::SwappedDbl);
 }
 
+///
+/// \brief MainWindow::on_menuExtraColumns_triggered
+/// \param action
+///
+void MainWindow::on_menuExtraColumns_triggered(QAction* action)
+{
+    Q_UNUSED(action)
+
+    auto frm = currentMdiChild();
+    if(!frm) return;
+
+    QVector<DataDisplayMode> modes;
+    for(auto&& a : ui->menuExtraColumns->actions())
+    {
+        if(a->isChecked())
+            modes.append((DataDisplayMode)a->data().toUInt());
+    }
+    frm->setExtraColumns(modes);
+}
+
 ///
 /// \brief MainWindow::on_actionLittleEndian_triggered
 ///
@@ -819,6 +885,19 @@ void MainWindow::on_actionAddressScan_triggered()
     dlg->show();
 }
 
+///
+/// \brief MainWindow::on_actionBurstPolling_triggered
+///
+void MainWindow::on_actionBurstPolling_triggered()
+{
+    auto frm = currentMdiChild();
+    if(!frm) return;
+
+    auto dlg = new DialogBurstPolling(frm, this);
+    dlg->setAttribute(Qt::WA_DeleteOnClose, true);
+    dlg->show();
+}
+
 ///
 /// \brief MainWindow::on_actionTextCapture_triggered
 ///
@@ -846,6 +925,27 @@ void MainWindow::on_actionCaptureOff_triggered()
     frm->stopTextCapture();
 }
 
+///
+/// \brief MainWindow::on_actionStartTrace_triggered
+///
+void MainWindow::on_actionStartTrace_triggered()
+{
+    auto filename = QFileDialog::getSaveFileName(this, QString(), QString(), "Trace files (*.json)");
+    if(filename.isEmpty()) return;
+
+    if(!filename.endsWith(".json", Qt::CaseInsensitive)) filename += ".json";
+    if(!RequestTracer::instance().start(filename))
+        QMessageBox::warning(this, windowTitle(), tr("Unable to create trace file %1").arg(filename));
+}
+
+///
+/// \brief MainWindow::on_actionStopTrace_triggered
+///
+void MainWindow::on_actionStopTrace_triggered()
+{
+    RequestTracer::instance().stop();
+}
+
 ///
 /// \brief MainWindow::on_actionResetCtrs_triggered
 ///
@@ -984,7 +1084,7 @@ void MainWindow::on_actionTile_triggered()
 ///
 void MainWindow::on_actionWindows_triggered()
 {
-    DialogWindowsManager dlg(_windowActionList->actionList(), ui->actionSave, this);
+    DialogWindowsManager dlg(_windowActionList->actionList(), ui->actionSave, _dataSimulator, this);
     dlg.exec();
 }
 
@@ -1064,6 +1164,40 @@ void MainWindow::updateDataDisplayMode(DataDisplayMode mode)
     if(frm) frm->setDataDisplayMode(mode);
 }
 
+///
+/// \brief MainWindow::setupExtraColumnsMenu
+/// Fills the menu with a checkable copy of every display mode action
+///
+void MainWindow::setupExtraColumnsMenu()
+{
+    const QList<QPair<QAction*, DataDisplayMode>> modes = {
+        { ui->actionBinary, DataDisplayMode::Binary },
+        { ui->actionHex, DataDisplayMode::Hex },
+        { ui->actionInt16, DataDisplayMode::Int16 },
+        { ui->actionUInt16, DataDisplayMode::UInt16 },
+        { ui->actionInt32, DataDisplayMode::Int32 },
+        { ui->actionSwappedInt32, DataDisplayMode::SwappedInt32 },
+        { ui->actionUInt32, DataDisplayMode::UInt32 },
+        { ui->actionSwappedUInt32, DataDisplayMode::SwappedUInt32 },
+        { ui->actionInt64, DataDisplayMode::Int64 },
+        { ui->actionSwappedInt64, DataDisplayMode::SwappedInt64 },
+        { ui->actionUInt64, DataDisplayMode::UInt64 },
+        { ui->actionSwappedUInt64, DataDisplayMode::SwappedUInt64 },
+        { ui->actionFloatingPt, DataDisplayMode::FloatingPt },
+        { ui->actionSwappedFP, DataDisplayMode::SwappedFP },
+        { ui->actionDblFloat, DataDisplayMode::DblFloat },
+        { ui->actionSwappedDbl, DataDisplayMode::SwappedDbl }
+    };
+
+    ui->menuExtraColumns->clear();
+    for(auto&& m : modes)
+    {
+        auto action = ui->menuExtraColumns->addAction(m.first->icon(), m.first->text());
+        action->setCheckable(true);
+        action->setData((uint)m.second);
+    }
+}
+
 ///
 /// \brief MainWindow::createMdiChild
 /// \param id
@@ -1359,6 +1493,20 @@ void MainWindow::loadSettings()
     _lang = m.value("Language", "en").toString();
     setLanguage(_lang);
 
+    _metricsPort = m.value("MetricsPort", 0).toUInt();
+    if(_metricsPort > 0) startMetricsServer(_metricsPort);
+
+    const auto memoryBudget = m.value("MemoryBudget", MemoryBudget::instance().budget() / (1024 * 1024)).toLongLong();
+    MemoryBudget::instance().setBudget(memoryBudget * 1024 * 1024);
+
+    // DisplayFrameRate is only set in the ini file, 0 repaints on every reply
+    bool ok = false;
+    const auto frameRate = m.value("DisplayFrameRate").toInt(&ok);
+    if(ok && frameRate >= 0)
+        DisplayRefreshScheduler::instance().setFrameRate(qBound(0, frameRate, DisplayRefreshScheduler::MaxFrameRate));
+
+    qobject_cast<MainStatusBar*>(statusBar())->setEventLoopMonitorEnabled(m.value("EventLoopMonitor", true).toBool());
+
     m >> firstMdiChild();
     m >> _connParams;
 
@@ -1402,6 +1550,10 @@ void MainWindow::saveSettings()
     m.setValue("AutoStart", _autoStart);
     m.setValue("StartUpFile", _fileAutoStart);
     m.setValue("Language", _lang);
+    m.setValue("MetricsPort", _metricsPort);
+    m.setValue("MemoryBudget", MemoryBudget::instance().budget() / (1024 * 1024));
+    m.setValue("DisplayFrameRate", DisplayRefreshScheduler::instance().frameRate());
+    m.setValue("EventLoopMonitor", qobject_cast<MainStatusBar*>(statusBar())->eventLoopMonitorEnabled());
 
     m << firstMdiChild();
     m << _connParams;
@@ -7,6 +7,7 @@
 #include "formmodsca.h"
 #include "windowactionlist.h"
 #include "recentfileactionlist.h"
+#include "metricsserver.h"
 
 QT_BEGIN_NAMESPACE
 namespace Ui { class MainWindow; }
@@ -21,6 +22,7 @@ public:
     ~MainWindow();
 
     void setLanguage(const QString& lang);
+    bool startMetricsServer(quint16 port);
 
 signals:
     void modbusClientChanged(QModbusClient* cli);
@@ -73,6 +75,7 @@ private slots:
     void on_actionSwappedFP_triggered();
     void on_actionDblFloat_triggered();
     void on_actionSwappedDbl_triggered();
+    void on_menuExtraColumns_triggered(QAction* action);
     void on_actionLittleEndian_triggered();
     void on_actionBigEndian_triggered();
     void on_actionHexAddresses_triggered();
@@ -82,8 +85,11 @@ private slots:
     void on_actionUserMsg_triggered();
     void on_actionMsgParser_triggered();
     void on_actionAddressScan_triggered();
+    void on_actionBurstPolling_triggered();
     void on_actionTextCapture_triggered();
     void on_actionCaptureOff_triggered();
+    void on_actionStartTrace_triggered();
+    void on_actionStopTrace_triggered();
     void on_actionResetCtrs_triggered();
 
     /* View menu slots */
@@ -120,6 +126,7 @@ private slots:
 private:
     void addRecentFile(const QString& filename);
     void updateDataDisplayMode(DataDisplayMode mode);
+    void setupExtraColumnsMenu();
 
     FormModSca* createMdiChild(int id);
     FormModSca* currentMdiChild() const;
@@ -156,5 +163,8 @@ private:
     RecentFileActionList* _recentFileActionList;
     QPrinter* _selectedPrinter;
     DataSimulator* _dataSimulator;
+
+    quint16 _metricsPort;
+    MetricsServer _metricsServer;
 };
 #endif // MAINWINDOW_H
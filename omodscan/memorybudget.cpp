@@ -0,0 +1,66 @@
+#include "memorybudget.h"
+
+///
+/// \brief MemoryBudget::instance
+/// \return
+///
+MemoryBudget& MemoryBudget::instance()
+{
+    static MemoryBudget budget;
+    return budget;
+}
+
+///
+/// \brief MemoryBudget::MemoryBudget
+///
+MemoryBudget::MemoryBudget()
+    :_budget(256 * 1024 * 1024)
+    ,_used(0)
+{
+}
+
+///
+/// \brief MemoryBudget::setBudget
+/// \param bytes budget in bytes, 0 for unlimited
+///
+void MemoryBudget::setBudget(qint64 bytes)
+{
+    _budget = qMax<qint64>(0, bytes);
+}
+
+///
+/// \brief MemoryBudget::allocate
+/// \param bytes
+///
+void MemoryBudget::allocate(qint64 bytes)
+{
+    _used += bytes;
+}
+
+///
+/// \brief MemoryBudget::release
+/// \param bytes
+///
+void MemoryBudget::release(qint64 bytes)
+{
+    _used = qMax<qint64>(0, _used - bytes);
+}
+
+///
+/// \brief MemoryBudget::isExceeded
+/// \return
+///
+bool MemoryBudget::isExceeded() const
+{
+    return _budget > 0 && _used > _budget;
+}
+
+///
+/// \brief MemoryBudget::wouldExceed
+/// \param bytes
+/// \return true if allocating the given amount would exceed the budget
+///
+bool MemoryBudget::wouldExceed(qint64 bytes) const
+{
+    return _budget > 0 && _used + bytes > _budget;
+}
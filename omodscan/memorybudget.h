@@ -0,0 +1,41 @@
+#ifndef MEMORYBUDGET_H
+#define MEMORYBUDGET_H
+
+#include <QtGlobal>
+
+///
+/// \brief The MemoryBudget class
+/// Global accounting of the memory held by the traffic logs.
+/// Logs report every entry they keep and drop their oldest entries
+/// once the budget is exceeded.
+///
+class MemoryBudget
+{
+public:
+    static MemoryBudget& instance();
+
+    qint64 budget() const {
+        return _budget;
+    }
+    void setBudget(qint64 bytes);
+
+    qint64 used() const {
+        return _used;
+    }
+
+    void allocate(qint64 bytes);
+    void release(qint64 bytes);
+
+    bool isExceeded() const;
+    bool wouldExceed(qint64 bytes) const;
+
+private:
+    MemoryBudget();
+    Q_DISABLE_COPY(MemoryBudget)
+
+private:
+    qint64 _budget;
+    qint64 _used;
+};
+
+#endif // MEMORYBUDGET_H
@@ -0,0 +1,145 @@
+#include <QTcpSocket>
+#include "modbusmetrics.h"
+#include "metricsserver.h"
+
+///
+/// \brief Requests with headers larger than this are dropped
+///
+static constexpr int MaxRequestSize = 8192;
+
+///
+/// \brief MetricsServer::MetricsServer
+/// \param parent
+///
+MetricsServer::MetricsServer(QObject* parent)
+    : QObject(parent)
+{
+    _thread.setObjectName("MetricsServer");
+}
+
+///
+/// \brief MetricsServer::~MetricsServer
+///
+MetricsServer::~MetricsServer()
+{
+    stop();
+}
+
+///
+/// \brief MetricsServer::start
+/// \param port local TCP port
+/// \return
+///
+bool MetricsServer::start(quint16 port)
+{
+    stop();
+
+    auto listener = new MetricsListener;
+    listener->moveToThread(&_thread);
+    connect(&_thread, &QThread::finished, listener, &QObject::deleteLater);
+    _thread.start();
+
+    bool ok = false;
+    QString error;
+    QMetaObject::invokeMethod(listener, [listener, port, &ok, &error]
+    {
+        ok = listener->listen(QHostAddress::LocalHost, port);
+        if(!ok) error = listener->errorString();
+    }, Qt::BlockingQueuedConnection);
+
+    if(!ok)
+    {
+        _errorString = error;
+        stop();
+    }
+
+    return ok;
+}
+
+///
+/// \brief MetricsServer::stop
+///
+void MetricsServer::stop()
+{
+    if(!_thread.isRunning())
+        return;
+
+    _thread.quit();
+    _thread.wait();
+}
+
+///
+/// \brief MetricsListener::MetricsListener
+/// \param parent
+///
+MetricsListener::MetricsListener(QObject* parent)
+    : QTcpServer(parent)
+{
+    connect(this, &QTcpServer::newConnection, this, &MetricsListener::on_newConnection);
+}
+
+///
+/// \brief MetricsListener::on_newConnection
+///
+void MetricsListener::on_newConnection()
+{
+    while(auto socket = nextPendingConnection())
+    {
+        connect(socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater);
+        connect(socket, &QTcpSocket::readyRead, this, [this, socket]{ respond(socket); });
+    }
+}
+
+///
+/// \brief MetricsListener::respond
+/// \param socket
+///
+void MetricsListener::respond(QTcpSocket* socket)
+{
+    auto request = socket->property("Request").toByteArray() + socket->readAll();
+    if(request.size() > MaxRequestSize)
+    {
+        socket->abort();
+        return;
+    }
+
+    if(!request.contains("\r\n\r\n"))
+    {
+        socket->setProperty("Request", request);
+        return;
+    }
+
+    const auto requestLine = request.left(request.indexOf("\r\n")).split(' ');
+    const auto method = requestLine.value(0);
+    const auto path = requestLine.value(1);
+
+    QByteArray status, contentType, body;
+    if(method != "GET")
+    {
+        status = "405 Method Not Allowed";
+        contentType = "text/plain";
+        body = "Method Not Allowed\n";
+    }
+    else if(path == "/metrics" || path.startsWith("/metrics?"))
+    {
+        status = "200 OK";
+        contentType = "text/plain; version=0.0.4; charset=utf-8";
+        body = ModbusMetrics::instance().exposition();
+    }
+    else
+    {
+        status = "404 Not Found";
+        contentType = "text/plain";
+        body = "Not Found\n";
+    }
+
+    QByteArray response;
+    response += "HTTP/1.1 " + status + "\r\n";
+    response += "Content-Type: " + contentType + "\r\n";
+    response += "Content-Length: " + QByteArray::number(body.size()) + "\r\n";
+    response += "Connection: close\r\n\r\n";
+    response += body;
+
+    socket->write(response);
+    socket->disconnectFromHost();
+}
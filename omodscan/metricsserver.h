@@ -0,0 +1,54 @@
+#ifndef METRICSSERVER_H
+#define METRICSSERVER_H
+
+#include <QThread>
+#include <QTcpServer>
+
+///
+/// \brief The MetricsServer class
+/// Minimal HTTP listener on localhost serving ModbusMetrics at /metrics.
+/// It runs in its own thread, so scrapes do not wait for the event loop of the UI.
+///
+class MetricsServer : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit MetricsServer(QObject* parent = nullptr);
+    ~MetricsServer() override;
+
+    bool start(quint16 port);
+    void stop();
+
+    bool isRunning() const {
+        return _thread.isRunning();
+    }
+
+    QString errorString() const {
+        return _errorString;
+    }
+
+private:
+    QThread _thread;
+    QString _errorString;
+};
+
+///
+/// \brief The MetricsListener class
+/// Lives in the MetricsServer thread and answers the HTTP requests
+///
+class MetricsListener : public QTcpServer
+{
+    Q_OBJECT
+
+public:
+    explicit MetricsListener(QObject* parent = nullptr);
+
+private slots:
+    void on_newConnection();
+
+private:
+    void respond(QTcpSocket* socket);
+};
+
+#endif // METRICSSERVER_H
@@ -11,6 +11,7 @@ typedef QModbusRtuSerialMaster QModbusRtuSerialClient;
 #include "numericutils.h"
 #include "modbusexception.h"
 #include "modbusclient.h"
+#include "requesttracer.h"
 
 ///
 /// \brief ModbusClient::ModbusClient
@@ -20,7 +21,9 @@ ModbusClient::ModbusClient(QObject *parent)
     : QObject{parent}
     ,_modbusClient(nullptr)
     ,_connectionType(ConnectionType::Serial)
+    ,_metrics(nullptr)
 {
+    _clock.start();
 }
 
 ///
@@ -28,8 +31,27 @@ ModbusClient::ModbusClient(QObject *parent)
 ///
 ModbusClient::~ModbusClient()
 {
-    if(_modbusClient)
-        delete _modbusClient;
+    deleteClient();
+}
+
+///
+/// \brief ModbusClient::deleteClient
+/// Replies still in flight on the client leave the queue depth together with it,
+/// the ones it aborts on the way out are not counted again
+///
+void ModbusClient::deleteClient()
+{
+    if(_modbusClient == nullptr)
+        return;
+
+    if(_metrics)
+        _metrics->QueueDepth.fetch_sub(_inFlight, std::memory_order_relaxed);
+
+    _inFlight = 0;
+    _clientId++;
+
+    delete _modbusClient;
+    _modbusClient = nullptr;
 }
 
 ///
@@ -38,11 +60,7 @@ ModbusClient::~ModbusClient()
 ///
 void ModbusClient::connectDevice(const ConnectionDetails& cd)
 {
-    if(_modbusClient != nullptr)
-    {
-        delete _modbusClient;
-        _modbusClient = nullptr;
-    }
+    deleteClient();
 
     switch(cd.Type)
     {
@@ -79,8 +97,20 @@ void ModbusClient::connectDevice(const ConnectionDetails& cd)
     if(_modbusClient)
     {
         _connectionType = cd.Type;
+        _connectionName = (cd.Type == ConnectionType::Tcp) ?
+                              QString("%1:%2").arg(cd.TcpParams.IPAddress).arg(cd.TcpParams.ServicePort) :
+                              cd.SerialParams.PortName;
+        _metrics = ModbusMetrics::instance().connection(_connectionName);
+
         connect(_modbusClient, &QModbusDevice::stateChanged, this, &ModbusClient::on_stateChanged);
         connect(_modbusClient, &QModbusDevice::errorOccurred, this, &ModbusClient::on_errorOccurred);
+
+        if(auto device = _modbusClient->device())
+        {
+            connect(device, &QIODevice::bytesWritten, this, []{ RequestTracer::instance().markNextSent(); });
+            connect(device, &QIODevice::readyRead, this, []{ RequestTracer::instance().markNextFirstByte(); });
+        }
+
         _modbusClient->connectDevice();
     }
 }
@@ -132,22 +162,32 @@ void ModbusClient::sendRawRequest(const QModbusRequest& request, int server, int
         return;
     }
 
-    emit modbusRequest(requestId, server, ++_transactionId, request);
+    const auto requestTime = _clock.nsecsElapsed();
+    RequestTracer::instance().begin(++_transactionId, requestId, server, request.functionCode());
+    emit modbusRequest(requestId, server, _transactionId, request);
     if(auto reply = _modbusClient->sendRawRequest(request, server))
     {
         reply->setProperty("RequestId", requestId);
         reply->setProperty("TransactionId", _transactionId);
+        reply->setProperty("RequestTime", requestTime);
         if (!reply->isFinished())
         {
             connect(reply, &QModbusReply::finished, this, &ModbusClient::on_readReply);
+            updateQueueDepth(reply, 1);
+            return true;
         }
         else
         {
             delete reply; // broadcast replies return immediately
+            RequestTracer::instance().finish(_transactionId);
         }
     }
     else
-        emit modbusError(tr("Invalid Modbus Request"), requestId);
+    {
+        RequestTracer::instance().finish(_transactionId);
+    }
+
+    return false;
 }
 
 ///
@@ -157,33 +197,44 @@ void ModbusClient::sendRawRequest(const QModbusRequest& request, int server, int
 /// \param valueCount
 /// \param server
 /// \param requestId
+/// \return true if the request has been sent and a reply will follow
 ///
-void ModbusClient::sendReadRequest(QModbusDataUnit::RegisterType pointType, int startAddress, quint16 valueCount, int server, int requestId)
+bool ModbusClient::sendReadRequest(QModbusDataUnit::RegisterType pointType, int startAddress, quint16 valueCount, int server, int requestId)
 {
     if(_modbusClient == nullptr || state() != QModbusDevice::ConnectedState)
     {
-        return;
+        return false;
     }
 
     const QModbusDataUnit dataUnit(pointType, startAddress, valueCount);
     const auto request = createReadRequest(dataUnit);
-    if(!request.isValid()) return;
+    if(!request.isValid()) return false;
 
-    emit modbusRequest(requestId, server, ++_transactionId, request);
+    const auto requestTime = _clock.nsecsElapsed();
+    RequestTracer::instance().begin(++_transactionId, requestId, server, request.functionCode());
+    emit modbusRequest(requestId, server, _transactionId, request);
     if(auto reply = _modbusClient->sendReadRequest(dataUnit, server))
     {
         reply->setProperty("RequestId", requestId);
         reply->setProperty("TransactionId", _transactionId);
+        reply->setProperty("RequestTime", requestTime);
         reply->setProperty("RequestData", QVariant::fromValue(dataUnit));
         if (!reply->isFinished())
         {
             connect(reply, &QModbusReply::finished, this, &ModbusClient::on_readReply);
+            updateQueueDepth(reply, 1);
         }
         else
         {
             delete reply; // broadcast replies return immediately
+            RequestTracer::instance().finish(_transactionId);
         }
     }
+    else
+    {
+        RequestTracer::instance().finish(_transactionId);
+        emit modbusError(tr("Invalid Modbus Request"), requestId);
+    }
 }
 
 ///
@@ -507,21 +558,30 @@ void ModbusClient::writeRegister(QModbusDataUnit::RegisterType pointType, const
     const auto request = createWriteRequest(data, useMultipleWriteFunc);
     if(!request.isValid()) return;
 
-    emit modbusRequest(requestId, params.Node, ++_transactionId, request);
+    const auto requestTime = _clock.nsecsElapsed();
+    RequestTracer::instance().begin(++_transactionId, requestId, params.Node, request.functionCode());
+    emit modbusRequest(requestId, params.Node, _transactionId, request);
     if(auto reply = _modbusClient->sendRawRequest(request, params.Node))
     {
         reply->setProperty("RequestId", requestId);
         reply->setProperty("TransactionId", _transactionId);
+        reply->setProperty("RequestTime", requestTime);
         if (!reply->isFinished())
         {
             connect(reply, &QModbusReply::finished, this, &ModbusClient::on_writeReply);
+            updateQueueDepth(reply, 1);
         }
         else
         {
             // broadcast replies return immediately
             reply->deleteLater();
+            RequestTracer::instance().finish(_transactionId);
         }
     }
+    else
+    {
+        RequestTracer::instance().finish(_transactionId);
+    }
 }
 
 ///
@@ -540,22 +600,61 @@ void ModbusClient::maskWriteRegister(const ModbusMaskWriteParams& params, int re
 
     const auto addr = params.ZeroBasedAddress ? params.Address : params.Address - 1;
     QModbusRequest request(QModbusRequest::MaskWriteRegister, quint16(addr), params.AndMask, params.OrMask);
-    emit modbusRequest(requestId, params.Node, ++_transactionId, request);
+    const auto requestTime = _clock.nsecsElapsed();
+    RequestTracer::instance().begin(++_transactionId, requestId, params.Node, request.functionCode());
+    emit modbusRequest(requestId, params.Node, _transactionId, request);
 
     if(auto reply = _modbusClient->sendRawRequest(request, params.Node))
     {
         reply->setProperty("RequestId", requestId);
         reply->setProperty("TransactionId", _transactionId);
+        reply->setProperty("RequestTime", requestTime);
         if (!reply->isFinished())
         {
             connect(reply, &QModbusReply::finished, this, &ModbusClient::on_writeReply);
+            updateQueueDepth(reply, 1);
         }
         else
         {
             // broadcast replies return immediately
             reply->deleteLater();
+            RequestTracer::instance().finish(_transactionId);
         }
     }
+    else
+    {
+        RequestTracer::instance().finish(_transactionId);
+    }
+}
+
+///
+/// \brief ModbusClient::roundTripTime
+/// \param reply
+/// \return time in microseconds between the request and the reply, or -1 if unknown
+///
+qint64 ModbusClient::roundTripTime(const QModbusReply* reply)
+{
+    if(!reply) return -1;
+
+    const auto requestTime = reply->property("RequestTime");
+    const auto replyTime = reply->property("ReplyTime");
+    if(!requestTime.isValid() || !replyTime.isValid())
+        return -1;
+
+    return (replyTime.toLongLong() - requestTime.toLongLong()) / 1000;
+}
+
+///
+/// \brief ModbusClient::isDeviceReply
+/// Timeouts, aborted replies and connection errors never reached the device,
+/// their round trip times say nothing about it
+/// \param reply
+/// \return true if the device answered, with data or with an exception
+///
+bool ModbusClient::isDeviceReply(const QModbusReply* reply)
+{
+    return reply && (reply->error() == QModbusDevice::NoError ||
+                     reply->error() == QModbusDevice::ProtocolError);
 }
 
 ///
@@ -631,7 +730,15 @@ void ModbusClient::on_readReply()
     auto reply = qobject_cast<QModbusReply*>(sender());
     if (!reply) return;
 
+    reply->setProperty("ReplyTime", _clock.nsecsElapsed());
+    updateQueueDepth(reply, -1);
+
+    const auto transactionId = reply->property("TransactionId").toInt();
+    RequestTracer::instance().mark(transactionId, RequestTracer::Completed);
+
     emit modbusReply(reply);
+
+    RequestTracer::instance().release(transactionId);
     reply->deleteLater();
 }
 
@@ -643,6 +750,10 @@ void ModbusClient::on_writeReply()
     auto reply = qobject_cast<QModbusReply*>(sender());
     if (!reply) return;
 
+    reply->setProperty("ReplyTime", _clock.nsecsElapsed());
+    updateQueueDepth(reply, -1);
+    RequestTracer::instance().mark(reply->property("TransactionId").toInt(), RequestTracer::Completed);
+
     const auto raw  = reply->rawResult();
 
 #if QT_VERSION >= QT_VERSION_CHECK(6, 4, 0)
@@ -689,9 +800,28 @@ void ModbusClient::on_writeReply()
         break;
     }
 
+    RequestTracer::instance().release(reply->property("TransactionId").toInt());
     reply->deleteLater();
 }
 
+///
+/// \brief ModbusClient::updateQueueDepth
+/// Counts a reply when it is sent and when it finishes, replies of a client that has been replaced are left out
+/// \param reply
+/// \param delta
+///
+void ModbusClient::updateQueueDepth(QModbusReply* reply, int delta)
+{
+    if(delta > 0)
+        reply->setProperty("ClientId", _clientId);
+    else if(reply->property("ClientId").toUInt() != _clientId)
+        return;
+
+    _inFlight += delta;
+    if(_metrics)
+        _metrics->QueueDepth.fetch_add(delta, std::memory_order_relaxed);
+}
+
 ///
 /// \brief ModbusClient::on_errorOccurred
 /// \param error
@@ -734,6 +864,9 @@ void ModbusClient::on_stateChanged(QModbusDevice::State state)
             }
 
             _transactionId = -1;
+            if(_metrics && _metrics->Connects.fetch_add(1, std::memory_order_relaxed) > 0)
+                _metrics->Reconnects.fetch_add(1, std::memory_order_relaxed);
+
             emit modbusConnected(cd);
         }
         break;
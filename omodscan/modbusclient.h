@@ -2,8 +2,10 @@
 #define MODBUSCLIENT_H
 
 #include <QModbusClient>
+#include <QElapsedTimer>
 #include "connectiondetails.h"
 #include "modbuswriteparams.h"
+#include "modbusmetrics.h"
 
 Q_DECLARE_METATYPE(QModbusDataUnit)
 
@@ -27,6 +29,10 @@ public:
         return _connectionType;
     }
 
+    QString connectionName() const {
+        return _connectionName;
+    }
+
     int timeout() const;
     void setTimeout(int newTimeout);
 
@@ -34,10 +40,13 @@ public:
     void setNumberOfRetries(uint number);
 
     void sendRawRequest(const QModbusRequest& request, int server, int requestId);
-    void sendReadRequest(QModbusDataUnit::RegisterType pointType, int startAddress, quint16 valueCount, int server, int requestId);
+    bool sendReadRequest(QModbusDataUnit::RegisterType pointType, int startAddress, quint16 valueCount, int server, int requestId);
     void writeRegister(QModbusDataUnit::RegisterType pointType, const ModbusWriteParams& params, int requestId);
     void maskWriteRegister(const ModbusMaskWriteParams& params, int requestId);
 
+    static qint64 roundTripTime(const QModbusReply* reply);
+    static bool isDeviceReply(const QModbusReply* reply);
+
 signals:
     void modbusRequest(int requestId, int deviceId, int transactionId, const QModbusRequest& request);
     void modbusReply(QModbusReply* reply);
@@ -53,10 +62,21 @@ private slots:
     void on_errorOccurred(QModbusDevice::Error error);
     void on_stateChanged(QModbusDevice::State state);
 
+private:
+    void deleteClient();
+    void updateQueueDepth(QModbusReply* reply, int delta);
+
 private:
     int _transactionId = -1;
     QModbusClient* _modbusClient;
+
+    // replies of the current client that count towards the queue depth
+    int _inFlight = 0;
+    uint _clientId = 0;
     ConnectionType _connectionType;
+    QString _connectionName;
+    ModbusMetrics::Connection* _metrics;
+    QElapsedTimer _clock;
 };
 
 #endif // MODBUSCLIENT_H
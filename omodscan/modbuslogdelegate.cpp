@@ -0,0 +1,114 @@
+#include <QtMath>
+#include <QPainter>
+#include <QApplication>
+#include "glyphcache.h"
+#include "modbuslogwidget.h"
+#include "modbuslogdelegate.h"
+
+///
+/// \brief TextMargin
+/// Same margin HtmlDelegate gives its documents
+///
+static constexpr int TextMargin = 2;
+
+///
+/// \brief timestampText
+/// \param model
+/// \param row
+/// \return
+///
+static QString timestampText(const ModbusLogModel* model, int row)
+{
+    return model->timestamp(row).toString(Qt::ISODateWithMs);
+}
+
+///
+/// \brief messageText
+/// \param model
+/// \param row
+/// \param mode
+/// \return the text that follows the timestamp
+///
+static QString messageText(const ModbusLogModel* model, int row, DataDisplayMode mode)
+{
+    return QString(" %1 %2").arg(model->isRequest(row) ? QChar(0x2190) : QChar(0x2192), model->toString(row, mode));
+}
+
+///
+/// \brief boldFont
+/// \param font
+/// \return
+///
+static QFont boldFont(const QFont& font)
+{
+    auto bold = font;
+    bold.setBold(true);
+    return bold;
+}
+
+///
+/// \brief ModbusLogDelegate::ModbusLogDelegate
+/// \param parent
+///
+ModbusLogDelegate::ModbusLogDelegate(ModbusLogWidget* parent)
+    : QStyledItemDelegate(parent)
+    ,_parentWidget(parent)
+{
+}
+
+///
+/// \brief ModbusLogDelegate::paint
+/// \param painter
+/// \param option
+/// \param index
+///
+void ModbusLogDelegate::paint(QPainter* painter, const QStyleOptionViewItem& option, const QModelIndex& index) const
+{
+    // the text comes from the frame of the entry, the message object is not needed
+    const auto model = qobject_cast<const ModbusLogModel*>(index.model());
+    if(!model || index.row() >= model->rowCount())
+    {
+        QStyledItemDelegate::paint(painter, option, index);
+        return;
+    }
+
+    // the style draws the item without text, initStyleOption would ask for the HTML
+    QStyleOptionViewItem opt = option;
+    opt.index = index;
+    opt.text = QString();
+
+    QStyle* style = opt.widget ? opt.widget->style() : QApplication::style();
+    style->drawControl(QStyle::CE_ItemViewItem, &opt, painter, opt.widget);
+
+    QRectF rc = style->subElementRect(QStyle::SE_ItemViewItemText, &opt, opt.widget).adjusted(TextMargin, 0, -TextMargin, 0);
+
+    const auto role = (opt.state & QStyle::State_Selected) ? QPalette::HighlightedText : QPalette::Text;
+    auto& glyphs = GlyphCache::instance();
+
+    painter->save();
+    painter->setPen(opt.palette.color(QPalette::Active, role));
+    painter->setFont(boldFont(opt.font));
+    rc.setLeft(glyphs.drawText(*painter, rc, timestampText(model, index.row())));
+    painter->setFont(opt.font);
+    glyphs.drawText(*painter, rc, messageText(model, index.row(), _parentWidget->dataDisplayMode()));
+    painter->restore();
+}
+
+///
+/// \brief ModbusLogDelegate::sizeHint
+/// \param option
+/// \param index
+/// \return
+///
+QSize ModbusLogDelegate::sizeHint(const QStyleOptionViewItem& option, const QModelIndex& index) const
+{
+    const auto model = qobject_cast<const ModbusLogModel*>(index.model());
+    if(!model || index.row() >= model->rowCount())
+        return QStyledItemDelegate::sizeHint(option, index);
+
+    auto& glyphs = GlyphCache::instance();
+    const auto width = glyphs.horizontalAdvance(boldFont(option.font), timestampText(model, index.row())) +
+                       glyphs.horizontalAdvance(option.font, messageText(model, index.row(), _parentWidget->dataDisplayMode()));
+
+    return QSize(qCeil(width) + 2 * TextMargin, QFontMetrics(option.font).height() + 2 * TextMargin);
+}
@@ -0,0 +1,26 @@
+#ifndef MODBUSLOGDELEGATE_H
+#define MODBUSLOGDELEGATE_H
+
+#include <QStyledItemDelegate>
+
+class ModbusLogWidget;
+
+///
+/// \brief The ModbusLogDelegate class
+/// Draws the traffic log entries straight from their messages with the glyph
+/// cache, without building and laying out the HTML of the display text
+///
+class ModbusLogDelegate : public QStyledItemDelegate
+{
+public:
+    explicit ModbusLogDelegate(ModbusLogWidget* parent);
+
+protected:
+    void paint(QPainter* painter, const QStyleOptionViewItem& option, const QModelIndex& index) const override;
+    QSize sizeHint(const QStyleOptionViewItem& option, const QModelIndex& index) const override;
+
+private:
+    ModbusLogWidget* _parentWidget;
+};
+
+#endif // MODBUSLOGDELEGATE_H
@@ -135,6 +135,24 @@ public:
         return _adu->isValid();
     }
 
+    ///
+    /// \brief memoryUsage
+    /// \return approximate number of bytes held by the message
+    ///
+    qint64 memoryUsage() const {
+        return estimateMemoryUsage(_adu->rawData().size());
+    }
+
+    ///
+    /// \brief estimateMemoryUsage
+    /// \param aduSize
+    /// \return approximate number of bytes held by a message with the given ADU size
+    ///
+    static qint64 estimateMemoryUsage(int aduSize) {
+        // message and ADU objects, the byte array header and its payload
+        return sizeof(ModbusMessage) + sizeof(QModbusAduTcp) + 32 + aduSize;
+    }
+
     ///
     /// \brief timestamp
     /// \return
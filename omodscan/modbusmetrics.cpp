@@ -0,0 +1,180 @@
+#include <QTextStream>
+#include "modbusmetrics.h"
+
+///
+/// \brief Upper bounds of the round-trip time buckets, in microseconds
+///
+static const qint64 BucketBounds[ModbusMetrics::BucketCount] = {
+    1000, 2500, 5000, 10000, 25000, 50000, 100000, 250000, 500000, 1000000, 2500000, 5000000
+};
+
+///
+/// \brief escapeLabel
+/// \param value
+/// \return label value escaped for the text exposition format
+///
+static QString escapeLabel(const QString& value)
+{
+    QString s = value;
+    s.replace('\\', "\\\\");
+    s.replace('"', "\\\"");
+    s.replace('\n', "\\n");
+    return s;
+}
+
+///
+/// \brief ModbusMetrics::Series::addRoundTripTime
+/// \param usecs
+///
+void ModbusMetrics::Series::addRoundTripTime(qint64 usecs)
+{
+    if(usecs < 0)
+        return;
+
+    for(int i = 0; i < BucketCount; i++)
+    {
+        if(usecs <= BucketBounds[i])
+        {
+            RttBuckets[i].fetch_add(1, std::memory_order_relaxed);
+            break;
+        }
+    }
+
+    RttSum.fetch_add(usecs, std::memory_order_relaxed);
+    RttCount.fetch_add(1, std::memory_order_relaxed);
+}
+
+///
+/// \brief ModbusMetrics::instance
+/// \return
+///
+ModbusMetrics& ModbusMetrics::instance()
+{
+    static ModbusMetrics metrics;
+    return metrics;
+}
+
+///
+/// \brief ModbusMetrics::~ModbusMetrics
+///
+ModbusMetrics::~ModbusMetrics()
+{
+    qDeleteAll(_series);
+    qDeleteAll(_connections);
+}
+
+///
+/// \brief ModbusMetrics::series
+/// Series are never removed, so the returned pointer can be cached
+/// \param connection
+/// \param deviceId
+/// \param formId
+/// \return
+///
+ModbusMetrics::Series* ModbusMetrics::series(const QString& connection, int deviceId, int formId)
+{
+    QMutexLocker locker(&_mutex);
+
+    for(auto s : std::as_const(_series))
+    {
+        if(s->FormId == formId && s->DeviceId == deviceId && s->Connection == connection)
+            return s;
+    }
+
+    auto s = new Series;
+    s->Connection = connection;
+    s->DeviceId = deviceId;
+    s->FormId = formId;
+    _series.append(s);
+
+    return s;
+}
+
+///
+/// \brief ModbusMetrics::connection
+/// Connections are never removed, so the returned pointer can be cached
+/// \param name
+/// \return
+///
+ModbusMetrics::Connection* ModbusMetrics::connection(const QString& name)
+{
+    QMutexLocker locker(&_mutex);
+
+    for(auto c : std::as_const(_connections))
+    {
+        if(c->Name == name)
+            return c;
+    }
+
+    auto c = new Connection;
+    c->Name = name;
+    _connections.append(c);
+
+    return c;
+}
+
+///
+/// \brief ModbusMetrics::exposition
+/// \return all metrics in Prometheus text exposition format 0.0.4
+///
+QByteArray ModbusMetrics::exposition() const
+{
+    QList<Series*> series;
+    QList<Connection*> connections;
+    {
+        QMutexLocker locker(&_mutex);
+        series = _series;
+        connections = _connections;
+    }
+
+    QByteArray data;
+    QTextStream out(&data);
+
+    const auto labels = [](const Series* s) {
+        return QString("connection=\"%1\",device=\"%2\",form=\"%3\"").arg(escapeLabel(s->Connection)).arg(s->DeviceId).arg(s->FormId);
+    };
+
+    const auto counter = [&](const char* name, const char* help, std::atomic<quint64> Series::*field) {
+        out << "# HELP " << name << " " << help << "\n";
+        out << "# TYPE " << name << " counter\n";
+        for(auto s : std::as_const(series))
+            out << name << "{" << labels(s) << "} " << (s->*field).load(std::memory_order_relaxed) << "\n";
+    };
+
+    counter("omodscan_polls_total", "Read requests issued by a form.", &Series::Polls);
+    counter("omodscan_valid_responses_total", "Valid responses received by a form.", &Series::ValidResponses);
+    counter("omodscan_timeouts_total", "Requests that timed out.", &Series::Timeouts);
+    counter("omodscan_exceptions_total", "MODBUS exception responses.", &Series::Exceptions);
+
+    out << "# HELP omodscan_rtt_seconds Request round-trip time.\n";
+    out << "# TYPE omodscan_rtt_seconds histogram\n";
+    for(auto s : std::as_const(series))
+    {
+        const auto l = labels(s);
+
+        quint64 cumulative = 0;
+        for(int i = 0; i < BucketCount; i++)
+        {
+            cumulative += s->RttBuckets[i].load(std::memory_order_relaxed);
+            out << "omodscan_rtt_seconds_bucket{" << l << ",le=\"" << QString::number(BucketBounds[i] / 1e6, 'g', 6) << "\"} " << cumulative << "\n";
+        }
+
+        const auto count = s->RttCount.load(std::memory_order_relaxed);
+        out << "omodscan_rtt_seconds_bucket{" << l << ",le=\"+Inf\"} " << qMax(count, cumulative) << "\n";
+        out << "omodscan_rtt_seconds_sum{" << l << "} " << QString::number(s->RttSum.load(std::memory_order_relaxed) / 1e6, 'f', 6) << "\n";
+        out << "omodscan_rtt_seconds_count{" << l << "} " << qMax(count, cumulative) << "\n";
+    }
+
+    out << "# HELP omodscan_reconnects_total Connections re-established after the first one.\n";
+    out << "# TYPE omodscan_reconnects_total counter\n";
+    for(auto c : std::as_const(connections))
+        out << "omodscan_reconnects_total{connection=\"" << escapeLabel(c->Name) << "\"} " << c->Reconnects.load(std::memory_order_relaxed) << "\n";
+
+    out << "# HELP omodscan_queue_depth Requests sent and still waiting for a reply.\n";
+    out << "# TYPE omodscan_queue_depth gauge\n";
+    for(auto c : std::as_const(connections))
+        out << "omodscan_queue_depth{connection=\"" << escapeLabel(c->Name) << "\"} " << c->QueueDepth.load(std::memory_order_relaxed) << "\n";
+
+    out.flush();
+    return data;
+}
@@ -0,0 +1,70 @@
+#ifndef MODBUSMETRICS_H
+#define MODBUSMETRICS_H
+
+#include <atomic>
+#include <QList>
+#include <QMutex>
+#include <QString>
+
+///
+/// \brief The ModbusMetrics class
+/// Process wide registry of polling counters exported in Prometheus text format.
+/// Series are registered once under a lock; updating them is lock-free,
+/// so a scrape never blocks polling.
+///
+class ModbusMetrics
+{
+public:
+    static constexpr int BucketCount = 12;
+
+    ///
+    /// \brief Counters of one form polling one device over one connection
+    ///
+    struct Series
+    {
+        QString Connection;
+        int DeviceId = 0;
+        int FormId = 0;
+
+        std::atomic<quint64> Polls{0};
+        std::atomic<quint64> ValidResponses{0};
+        std::atomic<quint64> Timeouts{0};
+        std::atomic<quint64> Exceptions{0};
+        std::atomic<quint64> RttBuckets[BucketCount] = {};
+        std::atomic<quint64> RttCount{0};
+        std::atomic<quint64> RttSum{0};
+
+        void addRoundTripTime(qint64 usecs);
+    };
+
+    ///
+    /// \brief Counters of one connection
+    ///
+    struct Connection
+    {
+        QString Name;
+
+        std::atomic<quint64> Connects{0};
+        std::atomic<quint64> Reconnects{0};
+        std::atomic<int> QueueDepth{0};
+    };
+
+    static ModbusMetrics& instance();
+
+    Series* series(const QString& connection, int deviceId, int formId);
+    Connection* connection(const QString& name);
+
+    QByteArray exposition() const;
+
+private:
+    ModbusMetrics() = default;
+    ~ModbusMetrics();
+    Q_DISABLE_COPY(ModbusMetrics)
+
+private:
+    mutable QMutex _mutex;
+    QList<Series*> _series;
+    QList<Connection*> _connections;
+};
+
+#endif // MODBUSMETRICS_H
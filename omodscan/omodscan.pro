@@ -42,14 +42,17 @@ SOURCES += \
     controls/numericlineedit.cpp \
     controls/paritytypecombobox.cpp \
     controls/simulationmodecombobox.cpp \
+    controls/sparklinewidget.cpp \
     controls/statisticwidget.cpp \
     controls/numericcombobox.cpp \
+    controls/outputdataview.cpp \
     controls/outputwidget.cpp \
     controls/pointtypecombobox.cpp \
     datasimulator.cpp \
     dialogs/dialogmsgparser.cpp \
     dialogs/dialogabout.cpp \
     dialogs/dialogaddressscan.cpp \
+    dialogs/dialogburstpolling.cpp \
     dialogs/dialogautosimulation.cpp \
     dialogs/dialogautostart.cpp \
     dialogs/dialogcoilsimulation.cpp \
@@ -67,24 +70,40 @@ SOURCES += \
     dialogs/dialogwritecoilregister.cpp \
     dialogs/dialogwriteholdingregister.cpp \
     dialogs/dialogwriteholdingregisterbits.cpp \
+    displayrefreshscheduler.cpp \
+    eventloopmonitor.cpp \
+    formatpipeline.cpp \
     formmodsca.cpp \
+    glyphcache.cpp \
+    headlesspoller.cpp \
     htmldelegate.cpp \
+    latencyhistogram.cpp \
     main.cpp \
     mainwindow.cpp \
+    memorybudget.cpp \
+    metricsserver.cpp \
     modbusclient.cpp \
     modbusdataunit.cpp \
+    modbuslogdelegate.cpp \
+    modbusmetrics.cpp \
     modbusmessages/modbusmessage.cpp \
     modbusrtuscanner.cpp \
     modbusscanner.cpp \
     modbustcpscanner.cpp \
+    packedbits.cpp \
     qfixedsizedialog.cpp \
     qhexvalidator.cpp \
     qint64validator.cpp \
     quintvalidator.cpp \
     recentfileactionlist.cpp \
+    registerdecoder.cpp \
+    registerhistory.cpp \
+    requesttracer.cpp \
+    throughputmeter.cpp \
     windowactionlist.cpp
 
 HEADERS += \
+    burstpolling.h \
     byteorderutils.h \
     connectiondetails.h \
     controls/addressbasecombobox.h \
@@ -105,14 +124,17 @@ HEADERS += \
     controls/numericlineedit.h \
     controls/paritytypecombobox.h \
     controls/simulationmodecombobox.h \
+    controls/sparklinewidget.h \
     controls/statisticwidget.h \
     controls/numericcombobox.h \
+    controls/outputdataview.h \
     controls/outputwidget.h \
     controls/pointtypecombobox.h \
     datasimulator.h \
     dialogs/dialogmsgparser.h \
     dialogs/dialogabout.h \
     dialogs/dialogaddressscan.h \
+    dialogs/dialogburstpolling.h \
     dialogs/dialogautosimulation.h \
     dialogs/dialogautostart.h \
     dialogs/dialogcoilsimulation.h \
@@ -131,13 +153,23 @@ HEADERS += \
     dialogs/dialogwriteholdingregister.h \
     dialogs/dialogwriteholdingregisterbits.h \
     displaydefinition.h \
+    displayrefreshscheduler.h \
     enums.h \
+    eventloopmonitor.h \
+    fastformat.h \
+    formatpipeline.h \
     formatutils.h \
     formmodsca.h \
+    glyphcache.h \
+    headlesspoller.h \
     htmldelegate.h \
+    latencyhistogram.h \
     mainwindow.h \
+    memorybudget.h \
+    metricsserver.h \
     modbusclient.h \
     modbusdataunit.h \
+    modbuslogdelegate.h \
     modbusexception.h \
     modbusfunction.h \
     modbusmessages/diagnostics.h \
@@ -148,6 +180,7 @@ HEADERS += \
     modbusmessages/modbusmessages.h \
     modbusmessages/readcoils.h \
     modbuslimits.h \
+    modbusmetrics.h \
     modbusmessages/readdiscreteinputs.h \
     modbusmessages/readexceptionstatus.h \
     modbusmessages/readfifoqueue.h \
@@ -167,6 +200,7 @@ HEADERS += \
     modbustcpscanner.h \
     modbuswriteparams.h \
     numericutils.h \
+    packedbits.h \
     qfixedsizedialog.h \
     qhexvalidator.h \
     qint64validator.h \
@@ -176,6 +210,10 @@ HEADERS += \
     qrange.h \
     quintvalidator.h \
     recentfileactionlist.h \
+    registerdecoder.h \
+    registerhistory.h \
+    requesttracer.h \
+    throughputmeter.h \
     serialportutils.h \
     windowactionlist.h
 
@@ -185,6 +223,7 @@ FORMS += \
     dialogs/dialogmsgparser.ui \
     dialogs/dialogabout.ui \
     dialogs/dialogaddressscan.ui \
+    dialogs/dialogburstpolling.ui \
     dialogs/dialogautosimulation.ui \
     dialogs/dialogautostart.ui \
     dialogs/dialogcoilsimulation.ui \
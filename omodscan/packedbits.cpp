@@ -0,0 +1,110 @@
+#include <QtAlgorithms>
+#include "packedbits.h"
+
+///
+/// \brief PackedBits::resize
+/// \param count number of bits, all of them cleared
+///
+void PackedBits::resize(int count)
+{
+    _size = qMax(0, count);
+    _words.fill(0, (_size + 63) / 64);
+}
+
+///
+/// \brief PackedBits::clear
+///
+void PackedBits::clear()
+{
+    _size = 0;
+    _words.clear();
+}
+
+///
+/// \brief PackedBits::assign
+/// Packs the values of the data, any non zero value is a set bit
+/// \param data
+/// \param count number of bits, missing values read as cleared bits
+///
+void PackedBits::assign(const QModbusDataUnit& data, int count)
+{
+    resize(count);
+
+    const int n = qMin<int>(_size, data.valueCount());
+    for(int w = 0; w * 64 < n; w++)
+    {
+        quint64 word = 0;
+        const int last = qMin(n - w * 64, 64);
+        for(int b = 0; b < last; b++)
+            word |= quint64(data.value(w * 64 + b) != 0) << b;
+
+        _words[w] = word;
+    }
+}
+
+///
+/// \brief PackedBits::diff
+/// \param other bits of the same size
+/// \param changed receives the bits that differ
+/// \return true if any bit differs
+///
+bool PackedBits::diff(const PackedBits& other, PackedBits& changed) const
+{
+    changed.resize(_size);
+    if(other._size != _size)
+    {
+        changed._words.fill(~quint64(0));
+        if(_size % 64)
+            changed._words.last() = (quint64(1) << (_size % 64)) - 1;
+
+        return _size > 0;
+    }
+
+    quint64 any = 0;
+    for(int w = 0; w < _words.size(); w++)
+    {
+        changed._words[w] = _words[w] ^ other._words[w];
+        any |= changed._words[w];
+    }
+
+    return any != 0;
+}
+
+///
+/// \brief PackedBits::unite
+/// Sets the bits that are set in other, bits of other past the size are left out
+/// \param other
+///
+void PackedBits::unite(const PackedBits& other)
+{
+    const int words = qMin(_words.size(), other._words.size());
+    for(int w = 0; w < words; w++)
+        _words[w] |= other._words[w];
+
+    if(words > 0 && words == _words.size() && _size % 64)
+        _words[words - 1] &= (quint64(1) << (_size % 64)) - 1;
+}
+
+///
+/// \brief PackedBits::nextSetBit
+/// \param from
+/// \return the first set bit at or after from, -1 if there is none
+///
+int PackedBits::nextSetBit(int from) const
+{
+    if(from < 0) from = 0;
+    if(from >= _size)
+        return -1;
+
+    int w = from >> 6;
+    quint64 word = _words[w] & (~quint64(0) << (from & 63));
+    while(word == 0)
+    {
+        if(++w >= _words.size())
+            return -1;
+        word = _words[w];
+    }
+
+    const int bit = w * 64 + int(qCountTrailingZeroBits(word));
+    return bit < _size ? bit : -1;
+}
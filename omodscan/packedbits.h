@@ -0,0 +1,48 @@
+#ifndef PACKEDBITS_H
+#define PACKEDBITS_H
+
+#include <QVector>
+#include <QModbusDataUnit>
+
+///
+/// \brief The PackedBits class
+/// Coils and discrete inputs packed 64 to a word, so comparing two
+/// blocks of points takes one XOR per 64 points
+///
+class PackedBits
+{
+public:
+    int size() const {
+        return _size;
+    }
+
+    int wordCount() const {
+        return _words.size();
+    }
+
+    quint64 word(int n) const {
+        return _words[n];
+    }
+
+    bool testBit(int i) const {
+        return (_words[i >> 6] >> (i & 63)) & 1;
+    }
+
+    void resize(int count);
+    void clear();
+    void assign(const QModbusDataUnit& data, int count);
+
+    bool diff(const PackedBits& other, PackedBits& changed) const;
+    void unite(const PackedBits& other);
+    int nextSetBit(int from) const;
+
+    qint64 memoryUsage() const {
+        return _words.capacity() * sizeof(quint64);
+    }
+
+private:
+    int _size = 0;
+    QVector<quint64> _words;
+};
+
+#endif // PACKEDBITS_H
@@ -0,0 +1,331 @@
+#include <QtEndian>
+#include "registerdecoder.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define DECODE_SSE2
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#endif
+
+///
+/// \brief registersPerValue
+/// \param mode
+/// \return the number of words a single value is made of
+///
+int registersPerValue(DataDisplayMode mode)
+{
+    switch(mode)
+    {
+        case DataDisplayMode::FloatingPt:
+        case DataDisplayMode::SwappedFP:
+        case DataDisplayMode::Int32:
+        case DataDisplayMode::SwappedInt32:
+        case DataDisplayMode::UInt32:
+        case DataDisplayMode::SwappedUInt32:
+            return 2;
+
+        case DataDisplayMode::DblFloat:
+        case DataDisplayMode::SwappedDbl:
+        case DataDisplayMode::Int64:
+        case DataDisplayMode::SwappedInt64:
+        case DataDisplayMode::UInt64:
+        case DataDisplayMode::SwappedUInt64:
+            return 4;
+
+        default:
+            return 1;
+    }
+}
+
+///
+/// \brief needsByteSwap
+/// \param order
+/// \return true if toByteOrderValue swaps the bytes of a word on this host
+///
+static bool needsByteSwap(ByteOrder order)
+{
+#if Q_BYTE_ORDER == Q_BIG_ENDIAN
+    return order == ByteOrder::LittleEndian;
+#else
+    return order == ByteOrder::BigEndian;
+#endif
+}
+
+///
+/// \brief transformWordsT
+/// Copies the words to the destination swapping the bytes of every word and
+/// reversing the words of every group of Group words when asked to.
+/// This is what the make* functions of numericutils.h do to a single value.
+/// \param src
+/// \param words number of words, a multiple of the group
+/// \param dst
+///
+template<bool ByteSwap, int Group, bool Reverse>
+static void transformWordsT(const quint16* src, int words, void* dst)
+{
+    auto out = static_cast<char*>(dst);
+
+    if(!ByteSwap && !Reverse)
+    {
+        memcpy(out, src, words * sizeof(quint16));
+        return;
+    }
+
+    int i = 0;
+
+#if defined(__AVX2__)
+    for(; i + 16 <= words; i += 16)
+    {
+        auto v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+        if(ByteSwap)
+            v = _mm256_or_si256(_mm256_slli_epi16(v, 8), _mm256_srli_epi16(v, 8));
+        if(Reverse && Group == 2)
+            v = _mm256_or_si256(_mm256_slli_epi32(v, 16), _mm256_srli_epi32(v, 16));
+        if(Reverse && Group == 4)
+            v = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(v, _MM_SHUFFLE(0, 1, 2, 3)), _MM_SHUFFLE(0, 1, 2, 3));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i * sizeof(quint16)), v);
+    }
+#elif defined(DECODE_SSE2)
+    for(; i + 8 <= words; i += 8)
+    {
+        auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        if(ByteSwap)
+            v = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+        if(Reverse && Group == 2)
+            v = _mm_or_si128(_mm_slli_epi32(v, 16), _mm_srli_epi32(v, 16));
+        if(Reverse && Group == 4)
+            v = _mm_shufflehi_epi16(_mm_shufflelo_epi16(v, _MM_SHUFFLE(0, 1, 2, 3)), _MM_SHUFFLE(0, 1, 2, 3));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i * sizeof(quint16)), v);
+    }
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    for(; i + 8 <= words; i += 8)
+    {
+        auto v = vld1q_u16(src + i);
+        if(ByteSwap)
+            v = vreinterpretq_u16_u8(vrev16q_u8(vreinterpretq_u8_u16(v)));
+        if(Reverse && Group == 2)
+            v = vrev32q_u16(v);
+        if(Reverse && Group == 4)
+            v = vrev64q_u16(v);
+        uint8_t bytes[16];
+        vst1q_u8(bytes, vreinterpretq_u8_u16(v));
+        memcpy(out + i * sizeof(quint16), bytes, sizeof(bytes));
+    }
+#endif
+
+    for(; i < words; i += Group)
+    {
+        for(int k = 0; k < Group; k++)
+        {
+            quint16 w = src[i + (Reverse ? Group - 1 - k : k)];
+            if(ByteSwap) w = qbswap(w);
+            memcpy(out + (i + k) * sizeof(quint16), &w, sizeof(w));
+        }
+    }
+}
+
+///
+/// \brief transformWords
+/// Picks the specialized loop once for the whole array
+/// \param src
+/// \param words number of words, a multiple of the group
+/// \param byteSwap
+/// \param group 1, 2 or 4
+/// \param reverse
+/// \param dst
+///
+static void transformWords(const quint16* src, int words, bool byteSwap, int group, bool reverse, void* dst)
+{
+    typedef void (*Transform)(const quint16*, int, void*);
+    static const Transform table[2][3][2] = {
+        {
+            { transformWordsT<false, 1, false>, transformWordsT<false, 1, false> },
+            { transformWordsT<false, 2, false>, transformWordsT<false, 2, true> },
+            { transformWordsT<false, 4, false>, transformWordsT<false, 4, true> }
+        },
+        {
+            { transformWordsT<true, 1, false>, transformWordsT<true, 1, false> },
+            { transformWordsT<true, 2, false>, transformWordsT<true, 2, true> },
+            { transformWordsT<true, 4, false>, transformWordsT<true, 4, true> }
+        }
+    };
+
+    const int g = (group == 4) ? 2 : (group == 2) ? 1 : 0;
+    table[byteSwap][g][reverse](src, words, dst);
+}
+
+///
+/// \brief decodeUInt16Array
+/// \param src
+/// \param count number of values
+/// \param order
+/// \param dst
+///
+void decodeUInt16Array(const quint16* src, int count, ByteOrder order, quint16* dst)
+{
+    transformWords(src, count, needsByteSwap(order), 1, false, dst);
+}
+
+///
+/// \brief decodeInt16Array
+/// \param src
+/// \param count number of values
+/// \param order
+/// \param dst
+///
+void decodeInt16Array(const quint16* src, int count, ByteOrder order, qint16* dst)
+{
+    transformWords(src, count, needsByteSwap(order), 1, false, dst);
+}
+
+///
+/// \brief decodeUInt32Array
+/// \param src
+/// \param count number of values
+/// \param order
+/// \param swapped true if the high word comes first
+/// \param dst
+///
+void decodeUInt32Array(const quint16* src, int count, ByteOrder order, bool swapped, quint32* dst)
+{
+    transformWords(src, count * 2, needsByteSwap(order), 2, swapped, dst);
+}
+
+///
+/// \brief decodeInt32Array
+/// \param src
+/// \param count number of values
+/// \param order
+/// \param swapped true if the high word comes first
+/// \param dst
+///
+void decodeInt32Array(const quint16* src, int count, ByteOrder order, bool swapped, qint32* dst)
+{
+    transformWords(src, count * 2, needsByteSwap(order), 2, swapped, dst);
+}
+
+///
+/// \brief decodeFloatArray
+/// \param src
+/// \param count number of values
+/// \param order
+/// \param swapped true if the high word comes first
+/// \param dst
+///
+void decodeFloatArray(const quint16* src, int count, ByteOrder order, bool swapped, float* dst)
+{
+    transformWords(src, count * 2, needsByteSwap(order), 2, swapped, dst);
+}
+
+///
+/// \brief decodeUInt64Array
+/// \param src
+/// \param count number of values
+/// \param order
+/// \param swapped true if the highest word comes first
+/// \param dst
+///
+void decodeUInt64Array(const quint16* src, int count, ByteOrder order, bool swapped, quint64* dst)
+{
+    transformWords(src, count * 4, needsByteSwap(order), 4, swapped, dst);
+}
+
+///
+/// \brief decodeInt64Array
+/// \param src
+/// \param count number of values
+/// \param order
+/// \param swapped true if the highest word comes first
+/// \param dst
+///
+void decodeInt64Array(const quint16* src, int count, ByteOrder order, bool swapped, qint64* dst)
+{
+    transformWords(src, count * 4, needsByteSwap(order), 4, swapped, dst);
+}
+
+///
+/// \brief decodeDoubleArray
+/// \param src
+/// \param count number of values
+/// \param order
+/// \param swapped true if the highest word comes first
+/// \param dst
+///
+void decodeDoubleArray(const quint16* src, int count, ByteOrder order, bool swapped, double* dst)
+{
+    transformWords(src, count * 4, needsByteSwap(order), 4, swapped, dst);
+}
+
+///
+/// \brief isSwappedMode
+/// \param mode
+/// \return true if the mode takes the words of a value in reverse order
+///
+static bool isSwappedMode(DataDisplayMode mode)
+{
+    switch(mode)
+    {
+        case DataDisplayMode::SwappedFP:
+        case DataDisplayMode::SwappedDbl:
+        case DataDisplayMode::SwappedInt32:
+        case DataDisplayMode::SwappedUInt32:
+        case DataDisplayMode::SwappedInt64:
+        case DataDisplayMode::SwappedUInt64:
+            return true;
+
+        default:
+            return false;
+    }
+}
+
+///
+/// \brief DecodedRegisters::decode
+/// \param data
+/// \param length number of points, missing words read as zero
+/// \param mode
+/// \param order
+///
+void DecodedRegisters::decode(const QModbusDataUnit& data, int length, DataDisplayMode mode, ByteOrder order)
+{
+    auto words = data.values();
+    if(words.size() < length)
+        words.resize(length);
+
+    const int step = ::registersPerValue(mode);
+    _count = qMax(0, length) / step;
+    _storage.resize((_count * step + 3) / 4);
+
+    transformWords(words.constData(), _count * step, needsByteSwap(order), step, isSwappedMode(mode), _storage.data());
+
+    _mode = mode;
+    _order = order;
+    _valid = true;
+}
+
+///
+/// \brief DecodedRegisters::isDecodedAs
+/// Modes whose values are made of the same words in the same order share the decoded
+/// values, e.g. Hex, Int16 and UInt16 or FloatingPt, Int32 and UInt32
+/// \param mode
+/// \param order
+/// \return true if the values can be read as values of the mode
+///
+bool DecodedRegisters::isDecodedAs(DataDisplayMode mode, ByteOrder order) const
+{
+    return _valid && _order == order &&
+           ::registersPerValue(_mode) == ::registersPerValue(mode) &&
+           isSwappedMode(_mode) == isSwappedMode(mode);
+}
+
+///
+/// \brief DecodedRegisters::clear
+/// Invalidates the values, the storage is kept for the next decode
+///
+void DecodedRegisters::clear()
+{
+    _valid = false;
+    _count = 0;
+}
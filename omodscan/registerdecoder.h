@@ -0,0 +1,72 @@
+#ifndef REGISTERDECODER_H
+#define REGISTERDECODER_H
+
+#include <cstring>
+#include <QVector>
+#include <QModbusDataUnit>
+#include "enums.h"
+
+int registersPerValue(DataDisplayMode mode);
+
+void decodeUInt16Array(const quint16* src, int count, ByteOrder order, quint16* dst);
+void decodeInt16Array(const quint16* src, int count, ByteOrder order, qint16* dst);
+void decodeUInt32Array(const quint16* src, int count, ByteOrder order, bool swapped, quint32* dst);
+void decodeInt32Array(const quint16* src, int count, ByteOrder order, bool swapped, qint32* dst);
+void decodeFloatArray(const quint16* src, int count, ByteOrder order, bool swapped, float* dst);
+void decodeUInt64Array(const quint16* src, int count, ByteOrder order, bool swapped, quint64* dst);
+void decodeInt64Array(const quint16* src, int count, ByteOrder order, bool swapped, qint64* dst);
+void decodeDoubleArray(const quint16* src, int count, ByteOrder order, bool swapped, double* dst);
+
+///
+/// \brief The DecodedRegisters class
+/// The values of a register array decoded in one pass for a display mode and byte order.
+/// Value n is made of the words starting at n * registersPerValue().
+///
+class DecodedRegisters
+{
+public:
+    void decode(const QModbusDataUnit& data, int length, DataDisplayMode mode, ByteOrder order);
+    void clear();
+
+    bool isDecoded(DataDisplayMode mode, ByteOrder order) const {
+        return _valid && _mode == mode && _order == order;
+    }
+
+    bool isDecodedAs(DataDisplayMode mode, ByteOrder order) const;
+
+    DataDisplayMode mode() const {
+        return _mode;
+    }
+
+    ByteOrder order() const {
+        return _order;
+    }
+
+    int count() const {
+        return _count;
+    }
+
+    int registersPerValue() const {
+        return ::registersPerValue(_mode);
+    }
+
+    qint64 memoryUsage() const {
+        return _storage.capacity() * sizeof(quint64);
+    }
+
+    template<typename T>
+    T at(int idx) const {
+        T value;
+        memcpy(&value, reinterpret_cast<const char*>(_storage.constData()) + idx * sizeof(T), sizeof(T));
+        return value;
+    }
+
+private:
+    bool _valid = false;
+    int _count = 0;
+    DataDisplayMode _mode = DataDisplayMode::Binary;
+    ByteOrder _order = ByteOrder::LittleEndian;
+    QVector<quint64> _storage;
+};
+
+#endif // REGISTERDECODER_H
@@ -0,0 +1,212 @@
+#include <cstring>
+#include "numericutils.h"
+#include "registerdecoder.h"
+#include "registerhistory.h"
+
+///
+/// \brief TimestampWords
+/// Number of words the time of a sample takes in the buffer
+///
+static constexpr int TimestampWords = sizeof(qint64) / sizeof(quint16);
+
+///
+/// \brief decodeValue
+/// Decodes a single value the way the display mode shows it
+/// \param w the words of the value
+/// \param mode
+/// \param order
+/// \return
+///
+static double decodeValue(const quint16* w, DataDisplayMode mode, ByteOrder order)
+{
+    switch(mode)
+    {
+        case DataDisplayMode::Binary:
+        case DataDisplayMode::UInt16:
+        case DataDisplayMode::Hex:
+            return toByteOrderValue(w[0], order);
+
+        case DataDisplayMode::Int16:
+            return qint16(toByteOrderValue(w[0], order));
+
+        case DataDisplayMode::FloatingPt:
+            return makeFloat(w[0], w[1], order);
+
+        case DataDisplayMode::SwappedFP:
+            return makeFloat(w[1], w[0], order);
+
+        case DataDisplayMode::Int32:
+            return makeInt32(w[0], w[1], order);
+
+        case DataDisplayMode::SwappedInt32:
+            return makeInt32(w[1], w[0], order);
+
+        case DataDisplayMode::UInt32:
+            return makeUInt32(w[0], w[1], order);
+
+        case DataDisplayMode::SwappedUInt32:
+            return makeUInt32(w[1], w[0], order);
+
+        case DataDisplayMode::DblFloat:
+            return makeDouble(w[0], w[1], w[2], w[3], order);
+
+        case DataDisplayMode::SwappedDbl:
+            return makeDouble(w[3], w[2], w[1], w[0], order);
+
+        case DataDisplayMode::Int64:
+            return makeInt64(w[0], w[1], w[2], w[3], order);
+
+        case DataDisplayMode::SwappedInt64:
+            return makeInt64(w[3], w[2], w[1], w[0], order);
+
+        case DataDisplayMode::UInt64:
+            return quint64(makeUInt64(w[0], w[1], w[2], w[3], order));
+
+        case DataDisplayMode::SwappedUInt64:
+            return quint64(makeUInt64(w[3], w[2], w[1], w[0], order));
+    }
+
+    return 0;
+}
+
+///
+/// \brief RegisterHistory::setup
+/// Allocates the buffer for the depth and the number of rows and drops all samples
+/// \param depth number of samples to keep, 0 to keep none
+/// \param rows
+///
+void RegisterHistory::setup(int depth, int rows)
+{
+    _depth = qMax(0, depth);
+    _rows = qMax(0, rows);
+
+    if(isEnabled())
+    {
+        _buffer.resize(_depth * (_rows + TimestampWords));
+        _buffer.squeeze();
+    }
+    else
+    {
+        _buffer = QVector<quint16>();
+    }
+
+    clear();
+}
+
+///
+/// \brief RegisterHistory::clear
+/// Drops all samples, the buffer is kept
+///
+void RegisterHistory::clear()
+{
+    _head = 0;
+    _size = 0;
+}
+
+///
+/// \brief RegisterHistory::append
+/// Stores the words of the data as the newest sample, overwriting the oldest one when full
+/// \param data
+/// \param timestamp msecs since epoch the data was received at
+///
+void RegisterHistory::append(const QModbusDataUnit& data, qint64 timestamp)
+{
+    if(!isEnabled())
+        return;
+
+    auto slot = _buffer.data() + _head * (_rows + TimestampWords);
+    memcpy(slot, &timestamp, sizeof(timestamp));
+
+    auto words = slot + TimestampWords;
+    const int count = qMin<int>(_rows, data.valueCount());
+    for(int i = 0; i < count; i++)
+        words[i] = data.value(i);
+
+    if(count < _rows)
+        memset(words + count, 0, (_rows - count) * sizeof(quint16));
+
+    _head = (_head + 1) % _depth;
+    _size = qMin(_size + 1, _depth);
+}
+
+///
+/// \brief RegisterHistory::sample
+/// \param n sample number, 0 is the oldest one
+/// \return the slot of the sample, the words follow the time
+///
+const quint16* RegisterHistory::sample(int n) const
+{
+    const int slot = (_head - _size + n + _depth) % _depth;
+    return _buffer.constData() + slot * (_rows + TimestampWords);
+}
+
+///
+/// \brief RegisterHistory::timestamp
+/// \param n sample number, 0 is the oldest one
+/// \return msecs since epoch
+///
+qint64 RegisterHistory::timestamp(int n) const
+{
+    if(n < 0 || n >= _size)
+        return 0;
+
+    qint64 value;
+    memcpy(&value, sample(n), sizeof(value));
+    return value;
+}
+
+///
+/// \brief RegisterHistory::series
+/// Decodes the values of a row in all samples, oldest first
+/// \param row the first row of the value
+/// \param mode
+/// \param order
+/// \param values receives the values, the vector is reused between calls
+/// \return number of values, 0 if no value starts at the row
+///
+int RegisterHistory::series(int row, DataDisplayMode mode, ByteOrder order, QVector<double>& values) const
+{
+    const int step = registersPerValue(mode);
+    if(!isEnabled() || row < 0 || row % step || row + step > _rows)
+    {
+        values.resize(0);
+        return 0;
+    }
+
+    values.resize(_size);
+    for(int n = 0; n < _size; n++)
+        values[n] = decodeValue(sample(n) + TimestampWords + row, mode, order);
+
+    return _size;
+}
+
+///
+/// \brief RegisterHistory::statistics
+/// \param row the first row of the value
+/// \param mode
+/// \param order
+/// \return min, max and mean of the row over all samples
+///
+HistoryStatistics RegisterHistory::statistics(int row, DataDisplayMode mode, ByteOrder order) const
+{
+    HistoryStatistics stat;
+
+    QVector<double> values;
+    stat.Count = series(row, mode, order, values);
+    if(stat.Count <= 0)
+        return stat;
+
+    double sum = 0;
+    stat.Min = stat.Max = values[0];
+    for(auto&& v : values)
+    {
+        stat.Min = qMin(stat.Min, v);
+        stat.Max = qMax(stat.Max, v);
+        sum += v;
+    }
+
+    stat.Mean = sum / stat.Count;
+    stat.Span = timestamp(_size - 1) - timestamp(0);
+
+    return stat;
+}
@@ -0,0 +1,71 @@
+#ifndef REGISTERHISTORY_H
+#define REGISTERHISTORY_H
+
+#include <QVector>
+#include <QModbusDataUnit>
+#include "enums.h"
+
+///
+/// \brief The HistoryStatistics struct
+///
+struct HistoryStatistics
+{
+    int Count = 0;
+    double Min = 0;
+    double Max = 0;
+    double Mean = 0;
+    qint64 Span = 0;
+};
+
+///
+/// \brief The RegisterHistory class
+/// Keeps the last samples of a form in a ring buffer. A sample is the time it was
+/// received at followed by the raw words of every row, all samples share one
+/// buffer that is allocated once for the depth and the number of rows, so a form
+/// never holds more than depth * (rows + 4) words. Values are decoded from the
+/// words when they are asked for, so the history survives a change of the display mode.
+///
+class RegisterHistory
+{
+public:
+    void setup(int depth, int rows);
+    void clear();
+
+    bool isEnabled() const {
+        return _depth > 0 && _rows > 0;
+    }
+
+    int depth() const {
+        return _depth;
+    }
+
+    int rows() const {
+        return _rows;
+    }
+
+    int size() const {
+        return _size;
+    }
+
+    void append(const QModbusDataUnit& data, qint64 timestamp);
+
+    qint64 timestamp(int n) const;
+    int series(int row, DataDisplayMode mode, ByteOrder order, QVector<double>& values) const;
+    HistoryStatistics statistics(int row, DataDisplayMode mode, ByteOrder order) const;
+
+    qint64 memoryUsage() const {
+        return _buffer.capacity() * sizeof(quint16);
+    }
+
+private:
+    const quint16* sample(int n) const;
+
+private:
+    int _depth = 0;
+    int _rows = 0;
+    int _head = 0;
+    int _size = 0;
+    QVector<quint16> _buffer;
+};
+
+#endif // REGISTERHISTORY_H
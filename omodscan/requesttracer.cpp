@@ -0,0 +1,295 @@
+#include <utility>
+#include <algorithm>
+#include <QJsonObject>
+#include <QJsonDocument>
+#include "requesttracer.h"
+
+///
+/// \brief spanName
+/// \param stage
+/// \return name of the span that ends at the given stage
+///
+static const char* spanName(RequestTracer::Stage stage)
+{
+    switch(stage)
+    {
+        case RequestTracer::Queued:         return "schedule";
+        case RequestTracer::Sent:           return "queue";
+        case RequestTracer::FirstByte:      return "wire";
+        case RequestTracer::Completed:      return "receive";
+        case RequestTracer::Decoded:        return "decode";
+        case RequestTracer::ModelUpdated:   return "model update";
+        case RequestTracer::Painted:        return "paint";
+        default:                            return "";
+    }
+}
+
+///
+/// \brief RequestTracer::instance
+/// \return
+///
+RequestTracer& RequestTracer::instance()
+{
+    static RequestTracer tracer;
+    return tracer;
+}
+
+///
+/// \brief RequestTracer::RequestTracer
+///
+RequestTracer::RequestTracer()
+    :_enabled(false)
+    ,_firstEvent(true)
+{
+    _clock.start();
+}
+
+///
+/// \brief RequestTracer::start
+/// \param filename
+/// \return
+///
+bool RequestTracer::start(const QString& filename)
+{
+    stop();
+
+    _file.setFileName(filename);
+    if(!_file.open(QFile::WriteOnly | QFile::Truncate))
+        return false;
+
+    _file.write("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    _firstEvent = true;
+    _enabled = true;
+
+    return true;
+}
+
+///
+/// \brief RequestTracer::stop
+///
+void RequestTracer::stop()
+{
+    if(!_enabled)
+        return;
+
+    while(!_order.isEmpty())
+        finish(_order.first());
+
+    _file.write("\n]}\n");
+    _file.close();
+
+    _threads.clear();
+    _enabled = false;
+}
+
+///
+/// \brief RequestTracer::now
+/// \return nanoseconds of the monotonic trace clock
+///
+qint64 RequestTracer::now() const
+{
+    return _clock.nsecsElapsed();
+}
+
+///
+/// \brief RequestTracer::begin
+/// \param transactionId
+/// \param formId
+/// \param deviceId
+/// \param functionCode
+///
+void RequestTracer::begin(int transactionId, int formId, int deviceId, int functionCode)
+{
+    if(!_enabled)
+        return;
+
+    if(_records.contains(transactionId))
+        finish(transactionId);
+
+    Record rec;
+    rec.FormId = formId;
+    rec.DeviceId = deviceId;
+    rec.FunctionCode = functionCode;
+    std::fill(std::begin(rec.Stamps), std::end(rec.Stamps), -1);
+    rec.Stamps[Queued] = now();
+
+    _records.insert(transactionId, rec);
+    _order.append(transactionId);
+}
+
+///
+/// \brief RequestTracer::mark
+/// \param transactionId
+/// \param stage
+/// \param time timestamp from now(), or -1 for the current time
+///
+void RequestTracer::mark(int transactionId, Stage stage, qint64 time)
+{
+    if(!_enabled)
+        return;
+
+    auto it = _records.find(transactionId);
+    if(it == _records.end())
+        return;
+
+    it->Stamps[stage] = (time < 0) ? now() : time;
+    if(stage == Painted)
+        finish(transactionId);
+}
+
+///
+/// \brief RequestTracer::markNextSent
+///
+void RequestTracer::markNextSent()
+{
+    markNext(Sent, Queued);
+}
+
+///
+/// \brief RequestTracer::markNextFirstByte
+///
+void RequestTracer::markNextFirstByte()
+{
+    markNext(FirstByte, Sent);
+}
+
+///
+/// \brief RequestTracer::markNext
+/// Device level events carry no transaction id, so they are attributed
+/// to the oldest transaction that has reached the prerequisite stage only
+/// \param stage
+/// \param prerequisite
+///
+void RequestTracer::markNext(Stage stage, Stage prerequisite)
+{
+    if(!_enabled)
+        return;
+
+    for(auto&& id : std::as_const(_order))
+    {
+        auto& rec = _records[id];
+        if(rec.Stamps[Completed] != -1 || rec.Stamps[stage] != -1)
+            continue;
+
+        if(rec.Stamps[prerequisite] != -1)
+        {
+            rec.Stamps[stage] = now();
+            break;
+        }
+    }
+}
+
+///
+/// \brief RequestTracer::hold
+/// Keeps the transaction open past release, e.g. while its data waits for the next display frame.
+/// It is finished by the Painted mark or an explicit finish.
+/// \param transactionId
+///
+void RequestTracer::hold(int transactionId)
+{
+    if(!_enabled)
+        return;
+
+    auto it = _records.find(transactionId);
+    if(it != _records.end())
+        it->Held = true;
+}
+
+///
+/// \brief RequestTracer::release
+/// Finishes the transaction unless it is held or its data is still waiting to be painted
+/// \param transactionId
+///
+void RequestTracer::release(int transactionId)
+{
+    if(!_enabled)
+        return;
+
+    auto it = _records.constFind(transactionId);
+    if(it != _records.cend() && !it->Held && it->Stamps[ModelUpdated] == -1)
+        finish(transactionId);
+}
+
+///
+/// \brief RequestTracer::finish
+/// \param transactionId
+///
+void RequestTracer::finish(int transactionId)
+{
+    if(!_records.contains(transactionId))
+        return;
+
+    const auto rec = _records.take(transactionId);
+    _order.removeOne(transactionId);
+
+    const auto tid = rec.FormId;
+    if(!_threads.contains(tid))
+    {
+        _threads.insert(tid);
+
+        QString name;
+        if(tid > 0) name = QString("Form %1").arg(tid);
+        else if(tid == 0) name = "Global";
+        else name = "Scanner";
+
+        QJsonObject meta;
+        meta["ph"] = "M";
+        meta["pid"] = 1;
+        meta["tid"] = tid;
+        meta["name"] = "thread_name";
+        meta["args"] = QJsonObject{{ "name", name }};
+        writeEvent(QJsonDocument(meta).toJson(QJsonDocument::Compact));
+    }
+
+    const QJsonObject args {
+        { "form", rec.FormId },
+        { "device", rec.DeviceId },
+        { "function", QString("0x%1").arg(rec.FunctionCode, 2, 16, QLatin1Char('0')) },
+        { "transaction", transactionId }
+    };
+
+    const auto span = [&](const QString& name, qint64 from, qint64 to) {
+        QJsonObject e;
+        e["ph"] = "X";
+        e["pid"] = 1;
+        e["tid"] = tid;
+        e["name"] = name;
+        e["ts"] = from / 1000.0;
+        e["dur"] = qMax<qint64>(0, to - from) / 1000.0;
+        e["args"] = args;
+        writeEvent(QJsonDocument(e).toJson(QJsonDocument::Compact));
+    };
+
+    int first = -1, last = -1;
+    for(int i = 0; i < StageCount; i++)
+    {
+        if(rec.Stamps[i] == -1) continue;
+        if(first == -1) first = i;
+        last = i;
+    }
+
+    if(first == -1 || first == last)
+        return;
+
+    span(QString("transaction %1").arg(args["function"].toString()), rec.Stamps[first], rec.Stamps[last]);
+
+    for(int prev = first, i = first + 1; i <= last; i++)
+    {
+        if(rec.Stamps[i] == -1) continue;
+        span(spanName(Stage(i)), rec.Stamps[prev], rec.Stamps[i]);
+        prev = i;
+    }
+}
+
+///
+/// \brief RequestTracer::writeEvent
+/// \param json
+///
+void RequestTracer::writeEvent(const QByteArray& json)
+{
+    if(!_firstEvent)
+        _file.write(",\n");
+
+    _file.write(json);
+    _firstEvent = false;
+}
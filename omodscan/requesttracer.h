@@ -0,0 +1,80 @@
+#ifndef REQUESTTRACER_H
+#define REQUESTTRACER_H
+
+#include <QHash>
+#include <QList>
+#include <QSet>
+#include <QFile>
+#include <QElapsedTimer>
+
+///
+/// \brief The RequestTracer class
+/// Records the lifecycle of every MODBUS transaction and writes it
+/// as Chrome trace JSON (viewable in Perfetto or chrome://tracing)
+///
+class RequestTracer
+{
+public:
+    enum Stage
+    {
+        Scheduled = 0,
+        Queued,
+        Sent,
+        FirstByte,
+        Completed,
+        Decoded,
+        ModelUpdated,
+        Painted,
+        StageCount
+    };
+
+    static RequestTracer& instance();
+
+    bool isEnabled() const {
+        return _enabled;
+    }
+
+    QString filename() const {
+        return _file.fileName();
+    }
+
+    bool start(const QString& filename);
+    void stop();
+
+    qint64 now() const;
+
+    void begin(int transactionId, int formId, int deviceId, int functionCode);
+    void mark(int transactionId, Stage stage, qint64 time = -1);
+    void markNextSent();
+    void markNextFirstByte();
+    void hold(int transactionId);
+    void release(int transactionId);
+    void finish(int transactionId);
+
+private:
+    RequestTracer();
+    Q_DISABLE_COPY(RequestTracer)
+
+    struct Record
+    {
+        int FormId = 0;
+        int DeviceId = 0;
+        int FunctionCode = 0;
+        bool Held = false;
+        qint64 Stamps[StageCount] = {};
+    };
+
+    void markNext(Stage stage, Stage prerequisite);
+    void writeEvent(const QByteArray& json);
+
+private:
+    bool _enabled;
+    bool _firstEvent;
+    QFile _file;
+    QElapsedTimer _clock;
+    QList<int> _order;
+    QHash<int, Record> _records;
+    QSet<int> _threads;
+};
+
+#endif // REQUESTTRACER_H
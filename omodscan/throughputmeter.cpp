@@ -0,0 +1,202 @@
+#include "throughputmeter.h"
+
+///
+/// \brief ThroughputMeter::ThroughputMeter
+/// \param client
+/// \param parent
+///
+ThroughputMeter::ThroughputMeter(const ModbusClient& client, QObject* parent)
+    : QObject(parent)
+    ,_connectionType(ConnectionType::Tcp)
+    ,_bitsPerChar(0)
+    ,_baudRate(0)
+    ,_history(HistorySize)
+    ,_head(0)
+    ,_count(0)
+{
+    _timer.setInterval(1000);
+    connect(&_timer, &QTimer::timeout, this, &ThroughputMeter::on_timeout);
+
+    connect(&client, &ModbusClient::modbusRequest, this, &ThroughputMeter::on_modbusRequest);
+    connect(&client, &ModbusClient::modbusReply, this, &ThroughputMeter::on_modbusReply);
+    connect(&client, &ModbusClient::modbusConnected, this, &ThroughputMeter::on_modbusConnected);
+    connect(&client, &ModbusClient::modbusDisconnected, this, &ThroughputMeter::on_modbusDisconnected);
+}
+
+///
+/// \brief ThroughputMeter::current
+/// \return per-second rates averaged over the last AverageWindow seconds
+///
+ThroughputSample ThroughputMeter::current() const
+{
+    ThroughputSample result;
+
+    const int n = qMin(_count, AverageWindow);
+    if(n == 0) return result;
+
+    for(int i = 1; i <= n; i++)
+    {
+        const auto& s = _history[(_head - i + HistorySize) % HistorySize];
+        result.Requests += s.Requests;
+        result.Responses += s.Responses;
+        result.TxBytes += s.TxBytes;
+        result.RxBytes += s.RxBytes;
+        result.Timeouts += s.Timeouts;
+        result.Exceptions += s.Exceptions;
+        result.Utilisation += s.Utilisation;
+    }
+
+    result.Requests /= n;
+    result.Responses /= n;
+    result.TxBytes /= n;
+    result.RxBytes /= n;
+    result.Timeouts /= n;
+    result.Exceptions /= n;
+    result.Utilisation /= n;
+
+    return result;
+}
+
+///
+/// \brief ThroughputMeter::utilisationHistory
+/// \return oldest first
+///
+QVector<double> ThroughputMeter::utilisationHistory() const
+{
+    QVector<double> result;
+    result.reserve(_count);
+    for(int i = _count; i > 0; i--)
+        result.push_back(_history[(_head - i + HistorySize) % HistorySize].Utilisation);
+
+    return result;
+}
+
+///
+/// \brief ThroughputMeter::requestsHistory
+/// \return oldest first
+///
+QVector<double> ThroughputMeter::requestsHistory() const
+{
+    QVector<double> result;
+    result.reserve(_count);
+    for(int i = _count; i > 0; i--)
+        result.push_back(_history[(_head - i + HistorySize) % HistorySize].Requests);
+
+    return result;
+}
+
+///
+/// \brief ThroughputMeter::on_timeout
+///
+void ThroughputMeter::on_timeout()
+{
+    if(isSerial() && _baudRate > 0)
+    {
+        // every RTU frame is followed by at least 3.5 characters of silence
+        const auto chars = _bucket.TxBytes + _bucket.RxBytes + 3.5 * (_bucket.Requests + _bucket.Responses);
+        _bucket.Utilisation = qMin(1.0, chars * _bitsPerChar / _baudRate);
+    }
+
+    _history[_head] = _bucket;
+    _head = (_head + 1) % HistorySize;
+    _count = qMin(_count + 1, HistorySize);
+    _bucket = ThroughputSample();
+
+    emit updated();
+}
+
+///
+/// \brief ThroughputMeter::on_modbusRequest
+/// \param request
+///
+void ThroughputMeter::on_modbusRequest(int, int, int, const QModbusRequest& request)
+{
+    _bucket.Requests++;
+    _bucket.TxBytes += frameSize(request);
+}
+
+///
+/// \brief ThroughputMeter::on_modbusReply
+/// \param reply
+///
+void ThroughputMeter::on_modbusReply(QModbusReply* reply)
+{
+    if(!reply) return;
+
+    switch(reply->error())
+    {
+        case QModbusDevice::TimeoutError:
+            _bucket.Timeouts++;
+        return;
+
+        case QModbusDevice::ProtocolError:
+            _bucket.Exceptions++;
+        break;
+
+        default:
+        break;
+    }
+
+    const auto response = reply->rawResult();
+    if(response.isValid())
+    {
+        _bucket.Responses++;
+        _bucket.RxBytes += frameSize(response);
+    }
+}
+
+///
+/// \brief ThroughputMeter::on_modbusConnected
+/// \param cd
+///
+void ThroughputMeter::on_modbusConnected(const ConnectionDetails& cd)
+{
+    reset();
+
+    _connectionType = cd.Type;
+    if(cd.Type == ConnectionType::Serial)
+    {
+        const auto& sp = cd.SerialParams;
+        const double stopBits = (sp.StopBits == QSerialPort::OneAndHalfStop) ? 1.5 : double(sp.StopBits);
+        _bitsPerChar = 1 + sp.WordLength + (sp.Parity == QSerialPort::NoParity ? 0 : 1) + stopBits;
+        _baudRate = sp.BaudRate;
+    }
+
+    _timer.start();
+}
+
+///
+/// \brief ThroughputMeter::on_modbusDisconnected
+///
+void ThroughputMeter::on_modbusDisconnected(const ConnectionDetails&)
+{
+    _timer.stop();
+    reset();
+
+    emit updated();
+}
+
+///
+/// \brief ThroughputMeter::reset
+///
+void ThroughputMeter::reset()
+{
+    _bitsPerChar = 0;
+    _baudRate = 0;
+    _bucket = ThroughputSample();
+    _history.fill(ThroughputSample());
+    _head = 0;
+    _count = 0;
+}
+
+///
+/// \brief ThroughputMeter::frameSize
+/// RTU frames add address and CRC, TCP frames the 7 byte MBAP header
+/// \param pdu
+/// \return
+///
+int ThroughputMeter::frameSize(const QModbusPdu& pdu) const
+{
+    const int pduSize = pdu.size();
+    return (_connectionType == ConnectionType::Serial) ? pduSize + 3 : pduSize + 7;
+}
@@ -0,0 +1,71 @@
+#ifndef THROUGHPUTMETER_H
+#define THROUGHPUTMETER_H
+
+#include <QTimer>
+#include <QVector>
+#include "modbusclient.h"
+
+///
+/// \brief The ThroughputSample struct
+///
+struct ThroughputSample
+{
+    double Requests = 0;
+    double Responses = 0;
+    double TxBytes = 0;
+    double RxBytes = 0;
+    double Timeouts = 0;
+    double Exceptions = 0;
+    double Utilisation = 0; ///< serial line utilisation, 0..1 (always 0 for TCP)
+};
+Q_DECLARE_TYPEINFO(ThroughputSample, Q_PRIMITIVE_TYPE);
+
+///
+/// \brief The ThroughputMeter class
+/// Accumulates bus traffic from the ModbusClient request/reply stream
+/// into one-second buckets and reports rolling per-second rates
+///
+class ThroughputMeter : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit ThroughputMeter(const ModbusClient& client, QObject* parent = nullptr);
+
+    bool isSerial() const {
+        return _bitsPerChar > 0;
+    }
+
+    ThroughputSample current() const;
+    QVector<double> utilisationHistory() const;
+    QVector<double> requestsHistory() const;
+
+    static constexpr int HistorySize = 60;
+    static constexpr int AverageWindow = 5;
+
+signals:
+    void updated();
+
+private slots:
+    void on_timeout();
+    void on_modbusRequest(int requestId, int deviceId, int transactionId, const QModbusRequest& request);
+    void on_modbusReply(QModbusReply* reply);
+    void on_modbusConnected(const ConnectionDetails& cd);
+    void on_modbusDisconnected(const ConnectionDetails& cd);
+
+private:
+    void reset();
+    int frameSize(const QModbusPdu& pdu) const;
+
+private:
+    QTimer _timer;
+    ConnectionType _connectionType;
+    double _bitsPerChar;
+    double _baudRate;
+    ThroughputSample _bucket;
+    QVector<ThroughputSample> _history;
+    int _head;
+    int _count;
+};
+
+#endif // THROUGHPUTMETER_H